@@ -0,0 +1,251 @@
+#include "DFPlayerModel.h"
+#include "EmulatorClock.h"
+#include <string.h>
+
+/**
+ * @brief Construct a new DFPlayerModel object, powered off
+ */
+DFPlayerModel::DFPlayerModel(UartLink &link, const DFPlayerModelConfig &config) : link(link), parser()
+{
+    this->config = config;
+    powered = false;
+    booting = false;
+    bootDoneUs = 0;
+    playing = false;
+    playStartUs = 0;
+    playEndUs = 0;
+    track = 0;
+    volume = 30;
+    eq = DFPLAYER_EQ_NORMAL;
+    outboxCount = 0;
+    random = config.seed != 0 ? config.seed : 1;
+    memset(&stats, 0, sizeof(stats));
+}
+
+/**
+ * @brief Boot the module
+ */
+void DFPlayerModel::powerOn()
+{
+    powered = true;
+    boot();
+}
+
+/**
+ * @brief Reboot without being asked
+ */
+void DFPlayerModel::reboot()
+{
+    boot();
+    stats.reboots++;
+}
+
+void DFPlayerModel::boot()
+{
+    // What was playing stops, pending messages are lost
+    uint64_t now = emulatorMicros();
+    stopPlaying(now);
+    outboxCount = 0;
+    parser.reset();
+    booting = true;
+    bootDoneUs = now + (uint64_t)config.bootMs * 1000;
+}
+
+/**
+ * @brief Handle the bytes received by now and send what is due
+ */
+void DFPlayerModel::update()
+{
+    if (!powered)
+    {
+        return;
+    }
+    uint64_t now = emulatorMicros();
+
+    if (booting && now >= bootDoneUs)
+    {
+        booting = false;
+        post(DFPLAYER_MSG_ONLINE, 0x02, now, 0);
+    }
+
+    int byte;
+    while ((byte = link.read(UART_TO_DEVICE)) >= 0)
+    {
+        if (parser.push((uint8_t)byte))
+        {
+            handle(parser.frame(), now);
+        }
+    }
+    stats.badFrames = parser.getDropped();
+
+    if (playing && now >= playEndUs)
+    {
+        uint8_t finished = track;
+        stopPlaying(playEndUs);
+        // The module reports the end of a track twice
+        post(DFPLAYER_MSG_TRACK_FINISHED, finished, now, 0);
+        post(DFPLAYER_MSG_TRACK_FINISHED, finished, now + 2000, 0);
+    }
+
+    // Send what is due, in order
+    uint8_t kept = 0;
+    for (uint8_t i = 0; i < outboxCount; i++)
+    {
+        Message &message = outbox[i];
+        if (message.dueUs > now)
+        {
+            outbox[kept++] = message;
+            continue;
+        }
+        uint8_t frame[DFPLAYER_FRAME_SIZE];
+        dfPlayerEncode(message.command, message.parameter, false, frame);
+        for (uint8_t j = 0; j < DFPLAYER_FRAME_SIZE; j++)
+        {
+            link.send(UART_TO_HOST, frame[j]);
+        }
+        stats.replies++;
+        if (message.commandUs != 0)
+        {
+            uint64_t latency = link.idleAtUs(UART_TO_HOST) - message.commandUs;
+            stats.latencyUs += latency;
+            stats.answers++;
+            if (latency > stats.maxLatencyUs)
+            {
+                stats.maxLatencyUs = latency;
+            }
+        }
+    }
+    outboxCount = kept;
+}
+
+void DFPlayerModel::handle(const DFPlayerFrame &frame, uint64_t now)
+{
+    stats.frames++;
+    if (booting)
+    {
+        if (frame.command == DFPLAYER_CMD_RESET)
+        {
+            reboot();
+            return;
+        }
+        stats.busyErrors++;
+        answer(DFPLAYER_MSG_ERROR, DFPLAYER_ERROR_BUSY, now, false);
+        return;
+    }
+    if (frame.feedback)
+    {
+        answer(DFPLAYER_MSG_ACK, 0, now, true);
+    }
+
+    switch (frame.command)
+    {
+    case DFPLAYER_CMD_RESET:
+        reboot();
+        break;
+
+    case DFPLAYER_CMD_QUERY_STATUS:
+        answer(DFPLAYER_MSG_STATUS, 0x0200 | (playing ? 1 : 0), now, true);
+        break;
+
+    case DFPLAYER_CMD_PLAY_FOLDER:
+    {
+        uint8_t folder = frame.parameter >> 8;
+        uint8_t number = frame.parameter & 0xFF;
+        if (folder == 0 || number == 0)
+        {
+            answer(DFPLAYER_MSG_ERROR, DFPLAYER_ERROR_FILE_MISMATCH, now, false);
+            break;
+        }
+        stopPlaying(now);
+        playing = true;
+        track = number;
+        playStartUs = now;
+        playEndUs = now + (uint64_t)trackMs(folder, number) * 1000;
+        stats.tracks++;
+        break;
+    }
+
+    case DFPLAYER_CMD_VOLUME:
+        volume = frame.parameter & 0xFF;
+        break;
+
+    case DFPLAYER_CMD_EQ:
+        eq = frame.parameter & 0xFF;
+        break;
+
+    default:
+        break;
+    }
+}
+
+void DFPlayerModel::answer(uint8_t command, uint16_t parameter, uint64_t now, bool droppable)
+{
+    if (droppable && withhold())
+    {
+        stats.withheld++;
+        return;
+    }
+    post(command, parameter, now + (uint64_t)config.replyMs * 1000, now);
+}
+
+void DFPlayerModel::post(uint8_t command, uint16_t parameter, uint64_t dueUs, uint64_t commandUs)
+{
+    if (outboxCount == DFPLAYER_MODEL_OUTBOX)
+    {
+        return;
+    }
+    Message &message = outbox[outboxCount++];
+    message.dueUs = dueUs;
+    message.commandUs = commandUs;
+    message.command = command;
+    message.parameter = parameter;
+}
+
+void DFPlayerModel::stopPlaying(uint64_t now)
+{
+    if (playing)
+    {
+        stats.playingUs += now - playStartUs;
+        playing = false;
+    }
+}
+
+bool DFPlayerModel::withhold()
+{
+    if (config.noReplyRate <= 0)
+    {
+        return false;
+    }
+    random ^= random << 13;
+    random ^= random >> 17;
+    random ^= random << 5;
+    return (random >> 8) < config.noReplyRate * (1 << 24);
+}
+
+/**
+ * @brief Check if a track is playing
+ */
+bool DFPlayerModel::isPlaying()
+{
+    return playing;
+}
+
+/**
+ * @brief Get the length of a track
+ */
+uint32_t DFPlayerModel::trackMs(uint8_t folder, uint8_t track)
+{
+    if (config.trackMs != 0)
+    {
+        return config.trackMs;
+    }
+    return 1000 + ((uint32_t)folder * 7919 + (uint32_t)track * 104729) % 5000;
+}
+
+/**
+ * @brief Get the module counters
+ */
+DFPlayerModelStats DFPlayerModel::getStats()
+{
+    return stats;
+}
@@ -0,0 +1,123 @@
+#ifndef DFPLAYER_MODEL_H
+#define DFPLAYER_MODEL_H
+
+#include <stdint.h>
+#include <DFPlayerProtocol.h>
+#include "UartLink.h"
+
+// Messages the module can have waiting to be sent
+#define DFPLAYER_MODEL_OUTBOX 8
+
+/**
+ * @brief Behavior of the emulated module
+ */
+typedef struct
+{
+    uint16_t bootMs;   // Reset to DFPLAYER_MSG_ONLINE
+    uint16_t replyMs;  // Command to its answer
+    uint32_t trackMs;  // Length of every track, 0 for lengths of 1-6s depending on the track
+    float noReplyRate; // Probability of leaving a status query or an ACK unanswered (0-1)
+    uint32_t seed;     // Seed of the fault sequence
+} DFPlayerModelConfig;
+
+/**
+ * @brief Module counters
+ */
+typedef struct
+{
+    uint32_t frames;       // Valid command frames received
+    uint32_t badFrames;    // Invalid frames dropped by the parser
+    uint32_t replies;      // Messages sent
+    uint32_t withheld;     // Answers left out (fault injection)
+    uint32_t busyErrors;   // Commands refused while booting
+    uint32_t tracks;       // Tracks started
+    uint32_t reboots;      // Resets and brown-outs, not counting power-on
+    uint64_t playingUs;    // Time spent playing
+    uint32_t maxLatencyUs; // Worst command end to answer end, on the wire
+    uint64_t latencyUs;    // Sum of command end to answer end
+    uint32_t answers;      // Answers the latency is measured on
+} DFPlayerModelStats;
+
+/**
+ * @brief DFPlayerModel class, a DFPlayer Mini at the other end of a UartLink
+ *
+ * Parses the real command frames with DFPlayerParser and answers with real
+ * frames: DFPLAYER_MSG_ONLINE after booting, DFPLAYER_MSG_ERROR (busy) to
+ * commands received while booting, DFPLAYER_MSG_STATUS to status queries,
+ * DFPLAYER_MSG_ACK when feedback is requested and DFPLAYER_MSG_TRACK_FINISHED
+ * when a track is over, twice as the real module does. Tracks keep the module
+ * busy for their length.
+ */
+class DFPlayerModel
+{
+public:
+    DFPlayerModel(UartLink &link, const DFPlayerModelConfig &config);
+
+    /**
+     * @brief Boot the module, DFPLAYER_MSG_ONLINE follows after bootMs
+     */
+    void powerOn();
+
+    /**
+     * @brief Reboot without being asked, as on a brown-out
+     */
+    void reboot();
+
+    /**
+     * @brief Handle the bytes received by now and send what is due
+     */
+    void update();
+
+    /**
+     * @brief Check if a track is playing (BUSY pin low)
+     */
+    bool isPlaying();
+
+    /**
+     * @brief Get the length of a track (ms)
+     */
+    uint32_t trackMs(uint8_t folder, uint8_t track);
+
+    /**
+     * @brief Get the module counters
+     */
+    DFPlayerModelStats getStats();
+
+private:
+    struct Message
+    {
+        uint64_t dueUs;
+        uint64_t commandUs; // End of the command answered, 0 if unsolicited
+        uint8_t command;
+        uint16_t parameter;
+    };
+
+    UartLink &link;
+    DFPlayerModelConfig config;
+    DFPlayerParser parser;
+
+    bool powered;
+    bool booting;
+    uint64_t bootDoneUs;
+    bool playing;
+    uint64_t playStartUs;
+    uint64_t playEndUs;
+    uint8_t track;
+    uint8_t volume;
+    uint8_t eq;
+
+    Message outbox[DFPLAYER_MODEL_OUTBOX];
+    uint8_t outboxCount;
+    uint32_t random; // xorshift32 state
+
+    DFPlayerModelStats stats;
+
+    void boot();
+    void handle(const DFPlayerFrame &frame, uint64_t now);
+    void answer(uint8_t command, uint16_t parameter, uint64_t now, bool droppable);
+    void post(uint8_t command, uint16_t parameter, uint64_t dueUs, uint64_t commandUs);
+    void stopPlaying(uint64_t now);
+    bool withhold();
+};
+
+#endif // DFPLAYER_MODEL_H
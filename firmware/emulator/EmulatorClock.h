@@ -0,0 +1,16 @@
+#ifndef EMULATOR_CLOCK_H
+#define EMULATOR_CLOCK_H
+
+#include <stdint.h>
+
+/**
+ * @brief Virtual time since the emulated boot (us), what micros() returns
+ */
+uint64_t emulatorMicros();
+
+/**
+ * @brief Move the virtual time forward
+ */
+void emulatorAdvance(uint64_t us);
+
+#endif // EMULATOR_CLOCK_H
@@ -0,0 +1,47 @@
+#include <FastAudio.h>
+
+// The DAC path is not emulated: no clip is ever found, every sound goes
+// to the DFPlayer
+
+FastAudio::FastAudio()
+{
+    pack = NULL;
+    clips = NULL;
+    clipCount = 0;
+    volume = 0;
+    dac = NULL;
+    events = NULL;
+    task = NULL;
+    request = NULL;
+    requestUs = 0;
+    running = false;
+    playing = false;
+    stats.plays = 0;
+    stats.underruns = 0;
+    stats.maxStartLatencyUs = 0;
+}
+
+bool FastAudio::begin(dac_channel_t dacChannel, uint8_t volume)
+{
+    return false;
+}
+
+bool FastAudio::hasClip(uint8_t folder, uint8_t track)
+{
+    return false;
+}
+
+bool FastAudio::play(uint8_t folder, uint8_t track)
+{
+    return false;
+}
+
+bool FastAudio::isPlaying()
+{
+    return false;
+}
+
+FastAudioStats FastAudio::getStats()
+{
+    return stats;
+}
@@ -0,0 +1,139 @@
+#include <Arduino.h>
+#include "EmulatorClock.h"
+#include "UartLink.h"
+
+// Arduino core and HardwareSerial on the virtual clock
+
+static uint64_t nowUs = 0;
+static uint32_t randomState = 1;
+static UartLink *uarts[3] = {NULL, NULL, NULL};
+
+/**
+ * @brief Virtual time since the emulated boot
+ */
+uint64_t emulatorMicros()
+{
+    return nowUs;
+}
+
+/**
+ * @brief Move the virtual time forward
+ */
+void emulatorAdvance(uint64_t us)
+{
+    nowUs += us;
+}
+
+unsigned long millis()
+{
+    return (unsigned long)(nowUs / 1000);
+}
+
+unsigned long micros()
+{
+    return (unsigned long)nowUs;
+}
+
+void delay(unsigned long ms)
+{
+    emulatorAdvance((uint64_t)ms * 1000);
+}
+
+void delayMicroseconds(unsigned int us)
+{
+    emulatorAdvance(us);
+}
+
+long random(long howbig)
+{
+    if (howbig <= 0)
+    {
+        return 0;
+    }
+    randomState ^= randomState << 13;
+    randomState ^= randomState >> 17;
+    randomState ^= randomState << 5;
+    return randomState % howbig;
+}
+
+long random(long howsmall, long howbig)
+{
+    if (howsmall >= howbig)
+    {
+        return howsmall;
+    }
+    return howsmall + random(howbig - howsmall);
+}
+
+void randomSeed(unsigned long seed)
+{
+    randomState = seed != 0 ? (uint32_t)seed : 1;
+}
+
+/**
+ * @brief Connect a UART of the emulated ESP32 to a link
+ */
+void emulatorAttachUart(uint8_t uartNum, UartLink *link)
+{
+    if (uartNum < 3)
+    {
+        uarts[uartNum] = link;
+    }
+}
+
+HardwareSerial::HardwareSerial(uint8_t uartNum)
+{
+    this->uartNum = uartNum < 3 ? uartNum : 0;
+}
+
+void HardwareSerial::begin(unsigned long baud, uint32_t config, int8_t rxPin, int8_t txPin)
+{
+    if (uarts[uartNum] != NULL)
+    {
+        uarts[uartNum]->setBaud(baud);
+    }
+}
+
+void HardwareSerial::end()
+{
+}
+
+int HardwareSerial::available()
+{
+    return uarts[uartNum] != NULL ? uarts[uartNum]->available(UART_TO_HOST) : 0;
+}
+
+int HardwareSerial::read()
+{
+    return uarts[uartNum] != NULL ? uarts[uartNum]->read(UART_TO_HOST) : -1;
+}
+
+size_t HardwareSerial::write(uint8_t byte)
+{
+    return write(&byte, 1);
+}
+
+size_t HardwareSerial::write(const uint8_t *buffer, size_t size)
+{
+    if (uarts[uartNum] == NULL)
+    {
+        return size;
+    }
+    size_t written = 0;
+    while (written < size && uarts[uartNum]->send(UART_TO_DEVICE, buffer[written]))
+    {
+        written++;
+    }
+    return written;
+}
+
+/**
+ * @brief Wait until every byte written is out, the clock moves
+ */
+void HardwareSerial::flush()
+{
+    if (uarts[uartNum] != NULL && uarts[uartNum]->idleAtUs(UART_TO_DEVICE) > nowUs)
+    {
+        nowUs = uarts[uartNum]->idleAtUs(UART_TO_DEVICE);
+    }
+}
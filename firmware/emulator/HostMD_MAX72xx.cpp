@@ -0,0 +1,151 @@
+#include <MD_MAX72xx.h>
+#include <string.h>
+#include "Max7219Model.h"
+#include "SpiBus.h"
+
+// MD_MAX72XX transfers, sent to the emulated SPI bus
+
+static SpiBus *spi = NULL;
+
+/**
+ * @brief Connect the SPI bus every MD_MAX72XX object sends to
+ */
+void emulatorAttachSpi(SpiBus *bus)
+{
+    spi = bus;
+}
+
+MD_MAX72XX::MD_MAX72XX(moduleType_t mod, uint8_t dataPin, uint8_t clkPin, uint8_t csPin, uint8_t numDevices)
+    : MD_MAX72XX(mod, csPin, numDevices)
+{
+}
+
+MD_MAX72XX::MD_MAX72XX(moduleType_t mod, uint8_t csPin, uint8_t numDevices)
+{
+    devices = numDevices > MAX_DEVICES ? MAX_DEVICES : numDevices;
+    updateEnabled = true;
+    memset(rows, 0, sizeof(rows));
+    memset(changed, 0, sizeof(changed));
+}
+
+/**
+ * @brief Same register sequence as the library: test off, full scan limit,
+ * half intensity, no decode, cleared digits, out of shutdown
+ */
+bool MD_MAX72XX::begin()
+{
+    control(TEST, OFF);
+    control(SCANLIMIT, MAX_SCANLIMIT);
+    control(INTENSITY, MAX_INTENSITY / 2);
+    control(DECODE, OFF);
+    clear();
+    control(SHUTDOWN, OFF);
+    return true;
+}
+
+bool MD_MAX72XX::control(controlRequest_t mode, int value)
+{
+    switch (mode)
+    {
+    case SHUTDOWN:
+        controlAll(MAX7219_REG_SHUTDOWN, value == OFF ? 1 : 0);
+        break;
+    case SCANLIMIT:
+        controlAll(MAX7219_REG_SCAN_LIMIT, value > MAX_SCANLIMIT ? MAX_SCANLIMIT : value);
+        break;
+    case INTENSITY:
+        controlAll(MAX7219_REG_INTENSITY, value > MAX_INTENSITY ? MAX_INTENSITY : value);
+        break;
+    case TEST:
+        controlAll(MAX7219_REG_DISPLAY_TEST, value == OFF ? 0 : 1);
+        break;
+    case DECODE:
+        controlAll(MAX7219_REG_DECODE_MODE, value == OFF ? 0x00 : 0xFF);
+        break;
+    case UPDATE:
+        updateEnabled = value == ON;
+        if (updateEnabled)
+        {
+            flush();
+        }
+        break;
+    default:
+        return false;
+    }
+    return true;
+}
+
+bool MD_MAX72XX::setRow(uint8_t buf, uint8_t r, uint8_t value)
+{
+    if (buf >= devices || r > 7)
+    {
+        return false;
+    }
+    rows[buf][r] = value;
+    changed[buf] |= 1 << r;
+    if (updateEnabled)
+    {
+        flush();
+    }
+    return true;
+}
+
+void MD_MAX72XX::clear()
+{
+    for (uint8_t dev = 0; dev < devices; dev++)
+    {
+        memset(rows[dev], 0, 8);
+        changed[dev] = 0xFF;
+    }
+    if (updateEnabled)
+    {
+        flush();
+    }
+}
+
+void MD_MAX72XX::controlAll(uint8_t reg, uint8_t data)
+{
+    uint8_t bytes[2 * MAX_DEVICES];
+    for (uint8_t i = 0; i < devices; i++)
+    {
+        bytes[2 * i] = reg;
+        bytes[2 * i + 1] = data;
+    }
+    if (spi != NULL)
+    {
+        spi->transfer(bytes, 2 * devices);
+    }
+}
+
+/**
+ * @brief One transaction per changed digit, no-ops for the devices where
+ * it did not change. The last device of the chain goes first.
+ */
+void MD_MAX72XX::flush()
+{
+    for (uint8_t r = 0; r < 8; r++)
+    {
+        uint8_t bytes[2 * MAX_DEVICES];
+        bool any = false;
+        for (uint8_t dev = 0; dev < devices; dev++)
+        {
+            uint8_t offset = 2 * (devices - 1 - dev);
+            if (changed[dev] & (1 << r))
+            {
+                bytes[offset] = MAX7219_REG_DIGIT0 + r;
+                bytes[offset + 1] = rows[dev][r];
+                any = true;
+            }
+            else
+            {
+                bytes[offset] = MAX7219_REG_NOOP;
+                bytes[offset + 1] = 0;
+            }
+        }
+        if (any && spi != NULL)
+        {
+            spi->transfer(bytes, 2 * devices);
+        }
+    }
+    memset(changed, 0, sizeof(changed));
+}
@@ -0,0 +1,152 @@
+#include "Max7219Model.h"
+#include <string.h>
+
+// Code B font: 0-9, '-', 'E', 'H', 'L', 'P', blank. Segments DP,A,B,C,D,E,F,G
+static const uint8_t CODE_B[16] = {
+    0x7E, 0x30, 0x6D, 0x79, 0x33, 0x5B, 0x5F, 0x70,
+    0x7F, 0x7B, 0x01, 0x4F, 0x37, 0x0E, 0x67, 0x00,
+};
+
+/**
+ * @brief Construct a new Max7219Model object, devices at power-up
+ */
+Max7219Model::Max7219Model(uint8_t devices)
+{
+    this->devices = devices > MAX7219_MODEL_MAX_DEVICES ? MAX7219_MODEL_MAX_DEVICES : devices;
+    memset(chain, 0, sizeof(chain));
+    shifted = 0;
+    selected = false;
+    memset(registers, 0, sizeof(registers));
+    for (uint8_t i = 0; i < MAX7219_MODEL_MAX_DEVICES; i++)
+    {
+        registers[i].shutdown = true;
+    }
+    memset(&stats, 0, sizeof(stats));
+}
+
+/**
+ * @brief CS falling edge, starts a transaction
+ */
+void Max7219Model::select()
+{
+    selected = true;
+    shifted = 0;
+}
+
+/**
+ * @brief Shift one byte in
+ *
+ * The byte enters device 0, the last byte of the chain falls out of the
+ * last device's DOUT.
+ */
+void Max7219Model::shift(uint8_t byte)
+{
+    if (!selected)
+    {
+        return; // DIN is ignored while CS is high
+    }
+    uint8_t length = 2 * devices;
+    memmove(chain, chain + 1, length - 1);
+    chain[length - 1] = byte;
+    shifted++;
+    stats.bytes++;
+}
+
+/**
+ * @brief CS rising edge, every device latches its word
+ */
+void Max7219Model::deselect()
+{
+    if (!selected)
+    {
+        return;
+    }
+    selected = false;
+    stats.transactions++;
+    if (shifted != 2 * devices)
+    {
+        stats.partial++;
+    }
+    for (uint8_t device = 0; device < devices; device++)
+    {
+        // Device 0 holds the last word shifted in
+        const uint8_t *word = &chain[2 * (devices - 1 - device)];
+        write(device, word[0] & 0x0F, word[1]);
+    }
+}
+
+void Max7219Model::write(uint8_t device, uint8_t address, uint8_t data)
+{
+    Max7219Registers &r = registers[device];
+    if (address == MAX7219_REG_NOOP)
+    {
+        stats.noops++;
+        return;
+    }
+    stats.writes++;
+    if (address >= MAX7219_REG_DIGIT0 && address < MAX7219_REG_DIGIT0 + 8)
+    {
+        r.digits[address - MAX7219_REG_DIGIT0] = data;
+        stats.digitWrites++;
+        return;
+    }
+    stats.controlWrites++;
+    switch (address)
+    {
+    case MAX7219_REG_DECODE_MODE:
+        r.decodeMode = data;
+        break;
+    case MAX7219_REG_INTENSITY:
+        r.intensity = data & 0x0F;
+        break;
+    case MAX7219_REG_SCAN_LIMIT:
+        r.scanLimit = data & 0x07;
+        break;
+    case MAX7219_REG_SHUTDOWN:
+        r.shutdown = (data & 0x01) == 0;
+        break;
+    case MAX7219_REG_DISPLAY_TEST:
+        r.displayTest = (data & 0x01) != 0;
+        break;
+    default:
+        break; // 0x0D and 0x0E are not used by the part
+    }
+}
+
+/**
+ * @brief Get the registers of a device
+ */
+const Max7219Registers &Max7219Model::getRegisters(uint8_t device)
+{
+    return registers[device < devices ? device : 0];
+}
+
+/**
+ * @brief Get what a digit actually shows
+ */
+uint8_t Max7219Model::visibleDigit(uint8_t device, uint8_t digit)
+{
+    const Max7219Registers &r = getRegisters(device);
+    if (r.displayTest)
+    {
+        return 0xFF; // Display test overrides shutdown
+    }
+    if (r.shutdown || digit > r.scanLimit)
+    {
+        return 0x00;
+    }
+    uint8_t data = r.digits[digit & 0x07];
+    if (r.decodeMode & (1 << digit))
+    {
+        return (data & 0x80) | CODE_B[data & 0x0F];
+    }
+    return data;
+}
+
+/**
+ * @brief Get the wire-level counters
+ */
+Max7219ModelStats Max7219Model::getStats()
+{
+    return stats;
+}
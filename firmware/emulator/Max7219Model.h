@@ -0,0 +1,107 @@
+#ifndef MAX7219_MODEL_H
+#define MAX7219_MODEL_H
+
+#include <stdint.h>
+
+// Register addresses (datasheet table 2)
+#define MAX7219_REG_NOOP 0x00
+#define MAX7219_REG_DIGIT0 0x01 // Digits 0-7 are 0x01-0x08
+#define MAX7219_REG_DECODE_MODE 0x09
+#define MAX7219_REG_INTENSITY 0x0A
+#define MAX7219_REG_SCAN_LIMIT 0x0B
+#define MAX7219_REG_SHUTDOWN 0x0C
+#define MAX7219_REG_DISPLAY_TEST 0x0F
+
+// Longest chain the model holds
+#define MAX7219_MODEL_MAX_DEVICES 8
+
+/**
+ * @brief Register state of one MAX7219
+ */
+typedef struct
+{
+    uint8_t digits[8];   // Digit registers, as written
+    uint8_t decodeMode;  // One bit per digit, Code B font
+    uint8_t intensity;   // 0-15
+    uint8_t scanLimit;   // Last scanned digit, 0-7
+    bool shutdown;       // Display blanked
+    bool displayTest;    // All segments on
+} Max7219Registers;
+
+/**
+ * @brief Wire-level counters of the chain
+ */
+typedef struct
+{
+    uint32_t transactions;  // CS low-high cycles
+    uint32_t bytes;         // Bytes shifted in
+    uint32_t writes;        // Registers latched, no-ops excluded
+    uint32_t noops;         // No-op words latched
+    uint32_t digitWrites;   // Digit registers latched
+    uint32_t controlWrites; // Decode, intensity, scan limit, shutdown and test registers latched
+    uint32_t partial;       // Transactions not shifting exactly one word per device
+} Max7219ModelStats;
+
+/**
+ * @brief Max7219Model class, a daisy chain of MAX7219 fed by the SPI stream
+ *
+ * Like the real chain, the devices form one long shift register: bytes enter
+ * device 0 and push the previous ones towards the end of the chain, and
+ * every device latches its 16 bits on the rising edge of CS. A transaction
+ * that does not shift one word per device therefore latches stale words
+ * into the far devices, as the hardware would.
+ *
+ * Power-up state follows the datasheet: shutdown, scan limit 0, no decode,
+ * intensity 0. The digit registers are not cleared at power-up on the real
+ * part, the model starts them at 0.
+ */
+class Max7219Model
+{
+public:
+    Max7219Model(uint8_t devices);
+
+    /**
+     * @brief CS falling edge, starts a transaction
+     */
+    void select();
+
+    /**
+     * @brief Shift one byte in, MSB first
+     */
+    void shift(uint8_t byte);
+
+    /**
+     * @brief CS rising edge, every device latches its word
+     */
+    void deselect();
+
+    /**
+     * @brief Get the registers of a device (0 is the first of the chain)
+     */
+    const Max7219Registers &getRegisters(uint8_t device);
+
+    /**
+     * @brief Get what a digit actually shows
+     *
+     * Blank when shut down or beyond the scan limit, all on in display test,
+     * Code B segments for decoded digits.
+     */
+    uint8_t visibleDigit(uint8_t device, uint8_t digit);
+
+    /**
+     * @brief Get the wire-level counters
+     */
+    Max7219ModelStats getStats();
+
+private:
+    uint8_t devices;
+    uint8_t chain[2 * MAX7219_MODEL_MAX_DEVICES]; // Shift register, device 0 last
+    uint16_t shifted;                              // Bytes in the current transaction
+    bool selected;
+    Max7219Registers registers[MAX7219_MODEL_MAX_DEVICES];
+    Max7219ModelStats stats;
+
+    void write(uint8_t device, uint8_t address, uint8_t data);
+};
+
+#endif // MAX7219_MODEL_H
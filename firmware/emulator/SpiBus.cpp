@@ -0,0 +1,50 @@
+#include "SpiBus.h"
+#include "EmulatorClock.h"
+
+/**
+ * @brief Construct a new SpiBus object
+ */
+SpiBus::SpiBus(Max7219Model &device, uint32_t clockHz, uint32_t csOverheadNs) : device(device)
+{
+    this->clockHz = clockHz > 0 ? clockHz : 1;
+    this->csOverheadNs = csOverheadNs;
+    residueNs = 0;
+    stats.transactions = 0;
+    stats.bytes = 0;
+    stats.busyUs = 0;
+    stats.maxTransactionUs = 0;
+}
+
+/**
+ * @brief One CS low-high cycle, the virtual clock moves by its duration
+ */
+void SpiBus::transfer(const uint8_t *bytes, size_t size)
+{
+    device.select();
+    for (size_t i = 0; i < size; i++)
+    {
+        device.shift(bytes[i]);
+    }
+    device.deselect();
+
+    uint64_t ns = csOverheadNs + (uint64_t)size * 8 * 1000000000ULL / clockHz + residueNs;
+    uint64_t us = ns / 1000;
+    residueNs = ns % 1000;
+    emulatorAdvance(us);
+
+    stats.transactions++;
+    stats.bytes += size;
+    stats.busyUs += us;
+    if (us > stats.maxTransactionUs)
+    {
+        stats.maxTransactionUs = us;
+    }
+}
+
+/**
+ * @brief Get the bus time counters
+ */
+SpiBusStats SpiBus::getStats()
+{
+    return stats;
+}
@@ -0,0 +1,54 @@
+#ifndef SPI_BUS_H
+#define SPI_BUS_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "Max7219Model.h"
+
+/**
+ * @brief Bus time counters
+ */
+typedef struct
+{
+    uint32_t transactions;
+    uint32_t bytes;
+    uint64_t busyUs; // Time the bus was driven, CS overhead included
+    uint32_t maxTransactionUs;
+} SpiBusStats;
+
+/**
+ * @brief SpiBus class, a blocking SPI master with the timing of the wire
+ *
+ * A transaction takes 8 clock periods per byte plus a fixed CS overhead
+ * (setup, hold and the driver's own time). The transfers block the CPU, as
+ * the MD_MAX72XX ones do, so the virtual clock moves by their duration.
+ */
+class SpiBus
+{
+public:
+    /**
+     * @param device Chain at the end of the bus
+     * @param clockHz SCK frequency (the MAX7219 takes up to 10MHz)
+     * @param csOverheadNs Fixed cost of a transaction besides the bits
+     */
+    SpiBus(Max7219Model &device, uint32_t clockHz, uint32_t csOverheadNs);
+
+    /**
+     * @brief One CS low-high cycle shifting bytes out
+     */
+    void transfer(const uint8_t *bytes, size_t size);
+
+    /**
+     * @brief Get the bus time counters
+     */
+    SpiBusStats getStats();
+
+private:
+    Max7219Model &device;
+    uint32_t clockHz;
+    uint32_t csOverheadNs;
+    uint64_t residueNs; // Sub-microsecond time carried over
+    SpiBusStats stats;
+};
+
+#endif // SPI_BUS_H
@@ -0,0 +1,126 @@
+#include "UartLink.h"
+#include "EmulatorClock.h"
+#include <string.h>
+
+/**
+ * @brief Construct a new UartLink object, idle and without faults
+ */
+UartLink::UartLink(uint32_t baud)
+{
+    memset(lines, 0, sizeof(lines));
+    setBaud(baud);
+    dropRate = 0;
+    random = 1;
+}
+
+/**
+ * @brief Change the baud rate
+ */
+void UartLink::setBaud(uint32_t baud)
+{
+    this->baud = baud > 0 ? baud : 1;
+}
+
+/**
+ * @brief Drop bytes at random
+ */
+void UartLink::setDropRate(float rate, uint32_t seed)
+{
+    dropRate = rate;
+    random = seed != 0 ? seed : 1;
+}
+
+bool UartLink::drop()
+{
+    if (dropRate <= 0)
+    {
+        return false;
+    }
+    random ^= random << 13;
+    random ^= random >> 17;
+    random ^= random << 5;
+    return (random >> 8) < dropRate * (1 << 24);
+}
+
+/**
+ * @brief Queue a byte, it starts when the line is done with the previous ones
+ */
+bool UartLink::send(UartDirection direction, uint8_t byte)
+{
+    Line &line = lines[direction];
+    if (line.count == UART_LINK_CAPACITY)
+    {
+        line.stats.overflows++;
+        return false;
+    }
+    uint64_t nowNs = emulatorMicros() * 1000;
+    uint64_t start = line.freeNs > nowNs ? line.freeNs : nowNs;
+    line.freeNs = start + byteTimeNs();
+    line.stats.bytes++;
+    line.stats.busyNs += byteTimeNs();
+    if (drop())
+    {
+        line.stats.dropped++;
+        return true;
+    }
+    uint16_t tail = (line.head + line.count) % UART_LINK_CAPACITY;
+    line.data[tail] = byte;
+    line.arrivalNs[tail] = line.freeNs;
+    line.count++;
+    return true;
+}
+
+/**
+ * @brief Number of bytes fully received by now
+ */
+int UartLink::available(UartDirection direction)
+{
+    Line &line = lines[direction];
+    uint64_t nowNs = emulatorMicros() * 1000;
+    int arrived = 0;
+    while (arrived < line.count && line.arrivalNs[(line.head + arrived) % UART_LINK_CAPACITY] <= nowNs)
+    {
+        arrived++;
+    }
+    return arrived;
+}
+
+/**
+ * @brief Read a received byte
+ */
+int UartLink::read(UartDirection direction)
+{
+    if (available(direction) == 0)
+    {
+        return -1;
+    }
+    Line &line = lines[direction];
+    uint8_t byte = line.data[line.head];
+    line.head = (line.head + 1) % UART_LINK_CAPACITY;
+    line.count--;
+    return byte;
+}
+
+/**
+ * @brief Time when the line is done with the bytes queued so far
+ */
+uint64_t UartLink::idleAtUs(UartDirection direction)
+{
+    return (lines[direction].freeNs + 999) / 1000;
+}
+
+/**
+ * @brief Transmission time of one byte, 10 bits
+ */
+uint32_t UartLink::byteTimeNs()
+{
+    return 10ULL * 1000000000ULL / baud;
+}
+
+/**
+ * @brief Get the line counters of a direction
+ */
+UartLinkStats UartLink::getStats(UartDirection direction)
+{
+    return lines[direction].stats;
+}
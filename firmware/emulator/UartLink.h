@@ -0,0 +1,108 @@
+#ifndef UART_LINK_H
+#define UART_LINK_H
+
+#include <stdint.h>
+
+// Bytes a direction can hold in flight, like a UART FIFO
+#define UART_LINK_CAPACITY 256
+
+/**
+ * @brief Link directions, seen from the ESP32
+ */
+enum UartDirection
+{
+    UART_TO_DEVICE, // ESP32 TX
+    UART_TO_HOST,   // ESP32 RX
+};
+
+/**
+ * @brief Line counters of one direction
+ */
+typedef struct
+{
+    uint32_t bytes;     // Bytes put on the line
+    uint32_t dropped;   // Bytes lost on the way (fault injection)
+    uint32_t overflows; // Bytes refused because the FIFO was full
+    uint64_t busyNs;    // Time the line was transmitting
+} UartLinkStats;
+
+/**
+ * @brief UartLink class, a full-duplex 8N1 serial line with the timing of the wire
+ *
+ * Each direction transmits one byte after the other, 10 bit times each
+ * (start, 8 data bits, stop): a byte can only be read once its stop bit has
+ * arrived. Bytes can be dropped on the way with a given probability, as a
+ * receiver does on a framing error; they still take their line time.
+ */
+class UartLink
+{
+public:
+    UartLink(uint32_t baud);
+
+    /**
+     * @brief Change the baud rate, for the bytes sent from now on
+     */
+    void setBaud(uint32_t baud);
+
+    /**
+     * @brief Drop bytes at random
+     *
+     * @param rate Probability of losing a byte (0-1), both directions
+     * @param seed Seed of the fault sequence, runs are reproducible
+     */
+    void setDropRate(float rate, uint32_t seed);
+
+    /**
+     * @brief Queue a byte for transmission, does not block
+     *
+     * @return false if the FIFO is full
+     */
+    bool send(UartDirection direction, uint8_t byte);
+
+    /**
+     * @brief Number of bytes fully received by now
+     */
+    int available(UartDirection direction);
+
+    /**
+     * @brief Read a received byte
+     *
+     * @return The byte, -1 if none has arrived
+     */
+    int read(UartDirection direction);
+
+    /**
+     * @brief Time when the line is done with the bytes queued so far (us)
+     */
+    uint64_t idleAtUs(UartDirection direction);
+
+    /**
+     * @brief Transmission time of one byte (ns)
+     */
+    uint32_t byteTimeNs();
+
+    /**
+     * @brief Get the line counters of a direction
+     */
+    UartLinkStats getStats(UartDirection direction);
+
+private:
+    struct Line
+    {
+        uint8_t data[UART_LINK_CAPACITY];
+        uint64_t arrivalNs[UART_LINK_CAPACITY];
+        uint16_t head;
+        uint16_t count;
+        uint64_t freeNs; // End of the last byte on the line
+        UartLinkStats stats;
+    };
+
+    Line lines[2];
+    uint32_t baud;
+    float dropRate;
+    uint32_t random; // xorshift32 state
+
+    bool drop();
+};
+
+#endif // UART_LINK_H
@@ -0,0 +1,372 @@
+// Wire-level emulator: runs the Eyes, TextScroller and Sounds code on the
+// host against a MAX7219 chain on an SPI bus and a DFPlayer on a 9600 baud
+// UART, both modeled at the byte level on a virtual clock. Reports what the
+// traffic costs on the wire.
+//
+// pio run -e emulator && .pio/build/emulator/program --help
+
+#include <stdio.h>
+#include <Eyes.h>
+#include <Max7219Display.h>
+#include <TextScroller.h>
+#include <Sounds.h>
+#include "../src/config.h"
+#include "EmulatorClock.h"
+#include "Max7219Model.h"
+#include "SpiBus.h"
+#include "UartLink.h"
+#include "DFPlayerModel.h"
+
+#define EMULATOR_DEVICES 2 // Right eye, then left eye
+
+typedef struct
+{
+  uint32_t seconds;
+  uint32_t spiHz;
+  uint32_t csOverheadNs;
+  uint16_t refreshHz;
+  float dropRate;
+  float noReplyRate;
+  uint32_t trackMs;
+  uint32_t rebootAtS;
+  uint32_t seed;
+} Options;
+
+/**
+ * Max7219Display wrapper timing the SPI traffic of every frame, and checking
+ * that the registers of the chain end up holding the frame
+ */
+class TimedDisplay : public EyesDisplay
+{
+public:
+  uint32_t frames = 0;      // Frames transferring at least one row
+  uint32_t emptyFrames = 0; // Frames with nothing to transfer
+  uint32_t rows = 0;
+  uint32_t transactions = 0;
+  uint64_t transferUs = 0;
+  uint32_t maxTransferUs = 0;
+  uint32_t controlTransactions = 0; // Intensity and shutdown writes
+  uint32_t intensityChanges = 0;
+  uint32_t mismatches = 0;          // Frames or shutdowns the registers do not match
+
+  TimedDisplay(Max7219Display &display, SpiBus &spi, Max7219Model &chain) : display(display), spi(spi), chain(chain) {}
+
+  void begin() override
+  {
+    display.begin();
+  }
+
+  void setIntensity(uint8_t intensity) override
+  {
+    SpiBusStats before = spi.getStats();
+    display.setIntensity(intensity);
+    controlTransactions += spi.getStats().transactions - before.transactions;
+    intensityChanges++;
+    for (uint8_t device = 0; device < EMULATOR_DEVICES; device++)
+    {
+      mismatches += chain.getRegisters(device).intensity != intensity;
+    }
+  }
+
+  void setShutdown(bool shutdown) override
+  {
+    SpiBusStats before = spi.getStats();
+    display.setShutdown(shutdown);
+    controlTransactions += spi.getStats().transactions - before.transactions;
+    for (uint8_t device = 0; device < EMULATOR_DEVICES; device++)
+    {
+      mismatches += chain.getRegisters(device).shutdown != shutdown;
+    }
+  }
+
+  uint8_t show(const EyesFrame &frame) override
+  {
+    SpiBusStats before = spi.getStats();
+    uint8_t sent = display.show(frame);
+    SpiBusStats after = spi.getStats();
+
+    uint32_t us = after.busyUs - before.busyUs;
+    if (sent == 0)
+    {
+      emptyFrames++;
+    }
+    else
+    {
+      frames++;
+      rows += sent;
+      transactions += after.transactions - before.transactions;
+      transferUs += us;
+      maxTransferUs = max(maxTransferUs, us);
+    }
+
+    for (uint8_t row = 0; row < 8; row++)
+    {
+      if (chain.getRegisters(0).digits[row] != frame.right[row] || chain.getRegisters(1).digits[row] != frame.left[row])
+      {
+        mismatches++;
+        break;
+      }
+    }
+    return sent;
+  }
+
+private:
+  Max7219Display &display;
+  SpiBus &spi;
+  Max7219Model &chain;
+};
+
+static void usage()
+{
+  printf("Usage: program [options]\n"
+         "  --seconds N      Virtual time to run (default 120)\n"
+         "  --spi-hz N       SPI clock (default 8000000, ~1000000 when bit-banged)\n"
+         "  --cs-ns N        Cost of a transaction besides its bits (default 2000)\n"
+         "  --refresh N      Frame rate while gliding (default EYES_REFRESH_RATE, 0 for pixel steps)\n"
+         "  --drop P         Probability of losing a UART byte, both ways (default 0)\n"
+         "  --no-reply P     Probability of the DFPlayer ignoring a status query (default 0)\n"
+         "  --track-ms N     Length of every track (default 1-6s depending on the track)\n"
+         "  --reboot-at S    DFPlayer reboots by itself at S seconds, as on a brown-out\n"
+         "  --seed N         Seed of the behavior and of the faults (default 1)\n");
+}
+
+static bool parseOptions(int argc, char **argv, Options &options)
+{
+  for (int i = 1; i < argc; i++)
+  {
+    const char *name = argv[i];
+    if (strcmp(name, "--help") == 0 || i + 1 >= argc)
+    {
+      return false;
+    }
+    const char *value = argv[++i];
+    if (strcmp(name, "--seconds") == 0)
+      options.seconds = strtoul(value, NULL, 0);
+    else if (strcmp(name, "--spi-hz") == 0)
+      options.spiHz = strtoul(value, NULL, 0);
+    else if (strcmp(name, "--cs-ns") == 0)
+      options.csOverheadNs = strtoul(value, NULL, 0);
+    else if (strcmp(name, "--refresh") == 0)
+      options.refreshHz = strtoul(value, NULL, 0);
+    else if (strcmp(name, "--drop") == 0)
+      options.dropRate = strtof(value, NULL);
+    else if (strcmp(name, "--no-reply") == 0)
+      options.noReplyRate = strtof(value, NULL);
+    else if (strcmp(name, "--track-ms") == 0)
+      options.trackMs = strtoul(value, NULL, 0);
+    else if (strcmp(name, "--reboot-at") == 0)
+      options.rebootAtS = strtoul(value, NULL, 0);
+    else if (strcmp(name, "--seed") == 0)
+      options.seed = strtoul(value, NULL, 0);
+    else
+      return false;
+  }
+  return true;
+}
+
+static double percent(uint64_t part, uint64_t whole)
+{
+  return whole > 0 ? 100.0 * part / whole : 0;
+}
+
+int main(int argc, char **argv)
+{
+  Options options = {120, 8000000, 2000, EYES_REFRESH_RATE, 0, 0, 0, 0, 1};
+  if (!parseOptions(argc, argv, options))
+  {
+    usage();
+    return 1;
+  }
+  randomSeed(options.seed);
+
+  // Wires and devices
+  Max7219Model chain(EMULATOR_DEVICES);
+  SpiBus spi(chain, options.spiHz, options.csOverheadNs);
+  emulatorAttachSpi(&spi);
+
+  UartLink uart(9600);
+  uart.setDropRate(options.dropRate, options.seed);
+  emulatorAttachUart(DFPLAYER_UART, &uart);
+  DFPlayerModelConfig playerConfig = {1500, 20, options.trackMs, options.noReplyRate, options.seed};
+  DFPlayerModel player(uart, playerConfig);
+  player.powerOn();
+
+  // Firmware side
+  Max7219Display max7219(HARDWARE_TYPE, CS_PIN);
+  TimedDisplay display(max7219, spi, chain);
+  Eyes eyes(display);
+  TextScroller text(eyes);
+  Sounds sounds(DFPLAYER_RX, DFPLAYER_TX, DFPLAYER_UART);
+
+  SoundsConfig soundsConfig = DFPLAYER_CONFIG;
+  soundsConfig.fastAudioDac = -1;
+  sounds.begin(soundsConfig);
+  eyes.begin();
+  eyes.setSmoothGaze(options.refreshHz, EYES_GAZE_SPEED);
+  eyes.setCanvasOrientation(TEXT_SWAP_PANELS, TEXT_MIRROR_COLUMNS);
+  text.begin(TEXT_SCROLL_SPEED);
+  SpiBusStats startup = spi.getStats();
+
+  // Behavior: random gazes, blinks, a flash now and then, a sound every
+  // 15s and a message every minute, under a flash or a breath as in the
+  // "boo" and "halloween" scenes
+  uint64_t endUs = (uint64_t)options.seconds * 1000000;
+  uint64_t nextGazeUs = 1000000;
+  uint64_t nextBlinkUs = 4000000;
+  uint64_t nextSoundUs = 5000000;
+  uint64_t nextTextUs = 30000000;
+  bool rebooted = options.rebootAtS == 0;
+  uint32_t soundsRequested = 0;
+  uint32_t messages = 0;
+  uint32_t messageIntensityStart = 0;
+  uint32_t flashSteps = 0;   // Intensity changes while a message scrolls
+  uint32_t breatheSteps = 0; // over a flash, over a breath
+  bool scrolling = false;
+
+  while (emulatorMicros() < endUs)
+  {
+    uint64_t now = emulatorMicros();
+    if (!rebooted && now >= (uint64_t)options.rebootAtS * 1000000)
+    {
+      player.reboot();
+      rebooted = true;
+    }
+    player.update();
+    sounds.update();
+
+    if (text.update())
+    {
+      eyes.updateIntensity();
+    }
+    else
+    {
+      if (scrolling)
+      {
+        // Message over: count the intensity steps taken under it
+        uint32_t steps = display.intensityChanges - messageIntensityStart;
+        if (messages % 2 == 1)
+        {
+          flashSteps += steps;
+        }
+        else
+        {
+          breatheSteps += steps;
+        }
+        eyes.fadeTo(255, 300);
+        scrolling = false;
+      }
+      eyes.update();
+      if (!eyes.isAnimating())
+      {
+        if (now >= nextTextUs)
+        {
+          text.start("HAPPY HALLOWEEN");
+          if (messages++ % 2 == 0)
+          {
+            eyes.flash(1000);
+          }
+          else
+          {
+            eyes.breathe(BREATHING_MIN_LEVEL, 255, 2000);
+          }
+          messageIntensityStart = display.intensityChanges;
+          scrolling = true;
+          nextTextUs = now + 60000000;
+        }
+        else if (now >= nextBlinkUs)
+        {
+          eyes.requestMode(CLOSED);
+          eyes.queueMode(NORMAL);
+          if (random(4) == 0)
+          {
+            eyes.flash(500);
+          }
+          nextBlinkUs = now + random(3000, 8000) * 1000;
+        }
+        else if (now >= nextGazeUs)
+        {
+          eyes.requestPosition(random(0, 7), random(0, 7));
+          nextGazeUs = now + random(800, 3000) * 1000;
+        }
+      }
+    }
+
+    if (now >= nextSoundUs)
+    {
+      soundsRequested++;
+      sounds.playSpeechOrEffectSound();
+      nextSoundUs = now + 15000000;
+    }
+
+    // Commands just sent start on the wire now
+    player.update();
+
+    // Idle until the next thing to do, like loop()
+    uint64_t wait = (uint64_t)LOOP_PERIOD * 1000;
+    wait = min(wait, (uint64_t)text.timeUntilNextStep());
+    wait = min(wait, (uint64_t)eyes.timeUntilNextFrame());
+    emulatorAdvance(max(wait, (uint64_t)100));
+  }
+
+  uint64_t elapsed = emulatorMicros();
+  SpiBusStats spiStats = spi.getStats();
+  Max7219ModelStats chainStats = chain.getStats();
+  EyesFrameStats frameStats = eyes.takeFrameStats();
+  UartLinkStats tx = uart.getStats(UART_TO_DEVICE);
+  UartLinkStats rx = uart.getStats(UART_TO_HOST);
+  DFPlayerModelStats playerStats = player.getStats();
+  SoundsStats soundsStats = sounds.getStats();
+
+  printf("[emulator] %lu s, SPI %lu Hz + %lu ns per transaction, UART 9600 baud 8N1\n",
+         (unsigned long)options.seconds, (unsigned long)options.spiHz, (unsigned long)options.csOverheadNs);
+
+  printf("[spi] %lu transactions, %lu bytes, busy %.1f ms (%.3f%% of the time), longest transaction %lu us, begin() %lu us\n",
+         (unsigned long)spiStats.transactions, (unsigned long)spiStats.bytes, spiStats.busyUs / 1000.0,
+         percent(spiStats.busyUs, elapsed), (unsigned long)spiStats.maxTransactionUs, (unsigned long)startup.busyUs);
+  printf("[spi] frames: %lu sent, %lu with nothing to send, %.2f rows and %.2f transactions per frame, %.1f us average, %lu us max\n",
+         (unsigned long)display.frames, (unsigned long)display.emptyFrames,
+         display.frames > 0 ? (double)display.rows / display.frames : 0,
+         display.frames > 0 ? (double)display.transactions / display.frames : 0,
+         display.frames > 0 ? (double)display.transferUs / display.frames : 0, (unsigned long)display.maxTransferUs);
+  printf("[spi] intensity and shutdown: %lu transactions\n", (unsigned long)display.controlTransactions);
+  printf("[text] %lu messages, intensity steps while scrolling: %lu under flashes, %lu under breaths\n",
+         (unsigned long)messages, (unsigned long)flashSteps, (unsigned long)breatheSteps);
+  printf("[spi] gliding: %lu frames over %.1f s, transfers %.2f%% of that time\n",
+         (unsigned long)frameStats.frames, frameStats.activeUs / 1e6, percent(frameStats.busyUs, frameStats.activeUs));
+
+  printf("[max7219] %lu writes (%lu digits, %lu control), %lu no-ops, %lu partial transactions, %lu register mismatches\n",
+         (unsigned long)chainStats.writes, (unsigned long)chainStats.digitWrites, (unsigned long)chainStats.controlWrites,
+         (unsigned long)chainStats.noops, (unsigned long)chainStats.partial, (unsigned long)display.mismatches);
+  for (uint8_t device = 0; device < EMULATOR_DEVICES; device++)
+  {
+    const Max7219Registers &r = chain.getRegisters(device);
+    printf("[max7219] device %u: decode 0x%02X, scan limit %u, intensity %u, %s%s, digits",
+           device, r.decodeMode, r.scanLimit, r.intensity, r.shutdown ? "shut down" : "on", r.displayTest ? ", test" : "");
+    for (uint8_t digit = 0; digit < 8; digit++)
+    {
+      printf(" %02X", chain.visibleDigit(device, digit));
+    }
+    printf("\n");
+  }
+
+  printf("[uart] tx: %lu bytes, %lu dropped, busy %.1f%%; rx: %lu bytes, %lu dropped, busy %.1f%%; %.2f ms per frame\n",
+         (unsigned long)tx.bytes, (unsigned long)tx.dropped, percent(tx.busyNs / 1000, elapsed),
+         (unsigned long)rx.bytes, (unsigned long)rx.dropped, percent(rx.busyNs / 1000, elapsed),
+         DFPLAYER_FRAME_SIZE * uart.byteTimeNs() / 1e6);
+  printf("[dfplayer] %lu frames, %lu invalid, %lu messages, %lu answers (%.1f ms average, %.1f ms max, command end to answer end), %lu withheld, %lu busy errors, %lu resets\n",
+         (unsigned long)playerStats.frames, (unsigned long)playerStats.badFrames, (unsigned long)playerStats.replies,
+         (unsigned long)playerStats.answers,
+         playerStats.answers > 0 ? playerStats.latencyUs / 1000.0 / playerStats.answers : 0,
+         playerStats.maxLatencyUs / 1000.0, (unsigned long)playerStats.withheld,
+         (unsigned long)playerStats.busyErrors, (unsigned long)playerStats.reboots);
+  printf("[dfplayer] %lu of %lu sounds played, playing %.1f%% of the time\n",
+         (unsigned long)playerStats.tracks, (unsigned long)soundsRequested, percent(playerStats.playingUs, elapsed));
+  printf("[sounds] %s, %lu disconnects, %lu recoveries, %lu timeouts, %lu error frames, unavailable %lu ms\n",
+         sounds.isAvailable() ? "online" : "offline", (unsigned long)soundsStats.disconnects,
+         (unsigned long)soundsStats.recoveries, (unsigned long)soundsStats.timeouts,
+         (unsigned long)soundsStats.errorFrames, (unsigned long)soundsStats.unavailableMs);
+
+  // A flash must decay, a breath must move, even while text owns the displays
+  bool frozen = (messages >= 1 && flashSteps == 0) || (messages >= 2 && breatheSteps == 0);
+  return display.mismatches == 0 && !frozen ? 0 : 2;
+}
@@ -0,0 +1,42 @@
+#ifndef ARDUINO_H
+#define ARDUINO_H
+
+// Host stand-in for the parts of the Arduino core the emulated libs use.
+// Time is virtual: it only moves when the emulator advances it, or when a
+// blocking transfer (SPI) takes bus time.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+
+// As in arduino-esp32 3.x: both arguments must have the same type
+using std::max;
+using std::min;
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+long random(long howbig);
+long random(long howsmall, long howbig);
+void randomSeed(unsigned long seed);
+
+// FreeRTOS handles only appear in members of classes not emulated
+typedef void *QueueHandle_t;
+typedef void *TaskHandle_t;
+typedef unsigned int UBaseType_t;
+typedef struct
+{
+    uint32_t owner;
+    uint32_t count;
+} portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED {0, 0}
+
+#include "HardwareSerial.h"
+
+#endif // ARDUINO_H
@@ -0,0 +1,39 @@
+#ifndef HARDWARE_SERIAL_H
+#define HARDWARE_SERIAL_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define SERIAL_8N1 0x800001c
+
+class UartLink;
+
+/**
+ * @brief Host HardwareSerial, the ESP32 end of an emulated UartLink
+ *
+ * Writes go to the TX FIFO and do not block, like the 128-byte hardware
+ * FIFO of the ESP32. Bytes are readable once they have fully arrived.
+ */
+class HardwareSerial
+{
+public:
+    HardwareSerial(uint8_t uartNum);
+
+    void begin(unsigned long baud, uint32_t config = SERIAL_8N1, int8_t rxPin = -1, int8_t txPin = -1);
+    void end();
+    int available();
+    int read();
+    size_t write(uint8_t byte);
+    size_t write(const uint8_t *buffer, size_t size);
+    void flush();
+
+private:
+    uint8_t uartNum;
+};
+
+/**
+ * @brief Connect a UART of the emulated ESP32 to a link
+ */
+void emulatorAttachUart(uint8_t uartNum, UartLink *link);
+
+#endif // HARDWARE_SERIAL_H
@@ -0,0 +1,80 @@
+#ifndef MD_MAX72XX_H
+#define MD_MAX72XX_H
+
+#include <stdint.h>
+
+class SpiBus;
+
+/**
+ * @brief Host MD_MAX72XX, sends the SPI stream of the library to an SpiBus
+ *
+ * Only the calls the firmware makes are there. Transfers follow the library:
+ * control() is one transaction writing the register of every device, and
+ * each flushed digit is one transaction across the chain where unchanged
+ * devices get a no-op. Rows map to digit registers as on GENERIC_HW, the
+ * column reordering of the other module types does not change the traffic.
+ */
+class MD_MAX72XX
+{
+public:
+    enum moduleType_t
+    {
+        DR0CR0RR0_HW,
+        DR0CR0RR1_HW,
+        DR0CR1RR0_HW,
+        DR0CR1RR1_HW,
+        DR1CR0RR0_HW,
+        DR1CR0RR1_HW,
+        DR1CR1RR0_HW,
+        DR1CR1RR1_HW,
+        GENERIC_HW = DR0CR0RR1_HW,
+        FC16_HW = DR1CR1RR0_HW,
+        PAROLA_HW = DR1CR1RR1_HW,
+        ICSTATION_HW = DR1CR1RR1_HW,
+    };
+
+    enum controlRequest_t
+    {
+        SHUTDOWN,
+        SCANLIMIT,
+        INTENSITY,
+        TEST,
+        DECODE,
+        UPDATE,
+        WRAPAROUND,
+    };
+
+    enum controlValue_t
+    {
+        OFF = 0,
+        ON = 1,
+    };
+
+    static const uint8_t MAX_INTENSITY = 0xF;
+    static const uint8_t MAX_SCANLIMIT = 7;
+    static const uint8_t MAX_DEVICES = 8;
+
+    MD_MAX72XX(moduleType_t mod, uint8_t dataPin, uint8_t clkPin, uint8_t csPin, uint8_t numDevices = 1);
+    MD_MAX72XX(moduleType_t mod, uint8_t csPin, uint8_t numDevices = 1);
+
+    bool begin();
+    bool control(controlRequest_t mode, int value);
+    bool setRow(uint8_t buf, uint8_t r, uint8_t value);
+    void clear();
+
+private:
+    uint8_t devices;
+    bool updateEnabled;
+    uint8_t rows[MAX_DEVICES][8];
+    uint8_t changed[MAX_DEVICES]; // One bit per row to flush
+
+    void controlAll(uint8_t reg, uint8_t data);
+    void flush();
+};
+
+/**
+ * @brief Connect the SPI bus every MD_MAX72XX object sends to
+ */
+void emulatorAttachSpi(SpiBus *bus);
+
+#endif // MD_MAX72XX_H
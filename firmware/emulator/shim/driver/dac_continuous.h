@@ -0,0 +1,23 @@
+#ifndef DRIVER_DAC_CONTINUOUS_H
+#define DRIVER_DAC_CONTINUOUS_H
+
+// Host stand-in: the DAC path is not emulated, see FastAudioHost.cpp
+
+#include <stddef.h>
+
+typedef enum
+{
+    DAC_CHAN_0,
+    DAC_CHAN_1,
+} dac_channel_t;
+
+typedef struct dac_continuous_s *dac_continuous_handle_t;
+
+typedef struct
+{
+    void *buf;
+    size_t buf_size;
+    size_t write_bytes;
+} dac_event_data_t;
+
+#endif // DRIVER_DAC_CONTINUOUS_H
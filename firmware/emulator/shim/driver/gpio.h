@@ -0,0 +1,11 @@
+#ifndef DRIVER_GPIO_H
+#define DRIVER_GPIO_H
+
+// Host stand-in: pad holds only matter around light sleep
+
+typedef int gpio_num_t;
+
+inline int gpio_hold_en(gpio_num_t) { return 0; }
+inline int gpio_hold_dis(gpio_num_t) { return 0; }
+
+#endif // DRIVER_GPIO_H
@@ -0,0 +1,6 @@
+#ifndef ESP_PARTITION_H
+#define ESP_PARTITION_H
+
+// Host stand-in: there is no flash, FastAudio finds no clips
+
+#endif // ESP_PARTITION_H
@@ -0,0 +1,17 @@
+#ifndef ESP_SLEEP_H
+#define ESP_SLEEP_H
+
+// Host stand-in: the emulator never sleeps
+
+typedef enum
+{
+    ESP_SLEEP_WAKEUP_UNDEFINED,
+    ESP_SLEEP_WAKEUP_TIMER,
+    ESP_SLEEP_WAKEUP_GPIO,
+    ESP_SLEEP_WAKEUP_UART,
+} esp_sleep_wakeup_cause_t;
+
+inline int esp_sleep_enable_uart_wakeup(int) { return 0; }
+inline esp_sleep_wakeup_cause_t esp_sleep_get_wakeup_cause() { return ESP_SLEEP_WAKEUP_UNDEFINED; }
+
+#endif // ESP_SLEEP_H
@@ -0,0 +1,187 @@
+#include "AmbientLight.h"
+
+volatile bool AmbientLight::frameReady = false;
+
+/**
+ * @brief Construct a new AmbientLight object
+ *
+ * @param pin ADC1 capable pin connected to the LDR divider
+ */
+AmbientLight::AmbientLight(uint8_t pin)
+{
+    this->pin = pin;
+    running = false;
+    filtered = 0;
+    primed = false;
+    level = 0;
+    lastRead = 0;
+}
+
+/**
+ * @brief Start sampling
+ *
+ * The driver averages CONVERSIONS_PER_FRAME samples in hardware/DMA and
+ * raises onFrame() once per frame, so the CPU only handles ~80 values per
+ * second whatever the sampling frequency is. In oneshot mode, the DMA is
+ * left to the DAC and update() reads the pin itself.
+ *
+ * @param config Mapping, filter and hysteresis settings
+ *
+ * @return true if the ADC continuous driver was started
+ */
+bool AmbientLight::begin(const AmbientLightConfig &config)
+{
+    this->config = config;
+    level = config.maxLevel;
+
+    if (config.oneshot)
+    {
+        analogReadResolution(12);
+        analogSetPinAttenuation(pin, ADC_11db);
+        running = true;
+        return true;
+    }
+
+    const uint8_t pins[] = {pin};
+    analogContinuousSetWidth(12);
+    analogContinuousSetAtten(ADC_11db);
+    if (!analogContinuous(pins, 1, CONVERSIONS_PER_FRAME, SAMPLING_FREQUENCY, &AmbientLight::onFrame))
+    {
+        return false;
+    }
+    running = analogContinuousStart();
+    return running;
+}
+
+/**
+ * @brief ADC continuous mode conversion-done callback (ISR context)
+ */
+void ARDUINO_ISR_ATTR AmbientLight::onFrame()
+{
+    frameReady = true;
+}
+
+/**
+ * @brief Consume pending ADC frames (call this in loop())
+ *
+ * @return true if the quantized brightness level changed, or was just
+ *         known from the first reading
+ */
+bool AmbientLight::update()
+{
+    uint32_t raw = 0;
+    if (!running || !read(raw))
+    {
+        return false;
+    }
+
+    uint32_t sample = raw << 8;
+    if (!primed)
+    {
+        // Start from the first reading instead of ramping up from 0, and
+        // report its level: the eyes start at whatever brightness they had
+        filtered = sample;
+        primed = true;
+        level = levelFor(raw);
+        return true;
+    }
+
+    // First order IIR: filtered += (sample - filtered) / 2^filterShift
+    int32_t delta = (int32_t)sample - (int32_t)filtered;
+    filtered = (uint32_t)((int32_t)filtered + (delta >> config.filterShift));
+
+    // Only move to another level once the reading is past the boundary
+    // by more than the hysteresis margin, in either direction
+    int32_t reading = filtered >> 8;
+    uint8_t a = levelFor(reading - config.hysteresis);
+    uint8_t b = levelFor(reading + config.hysteresis);
+    uint8_t lowest = min(a, b);
+    uint8_t highest = max(a, b);
+
+    uint8_t previous = level;
+    if (level < lowest)
+    {
+        level = lowest;
+    }
+    else if (level > highest)
+    {
+        level = highest;
+    }
+    return level != previous;
+}
+
+/**
+ * @brief Get the next raw reading if one is ready
+ *
+ * @param raw Reading (0-4095)
+ *
+ * @return true if a reading was taken
+ */
+bool AmbientLight::read(uint32_t &raw)
+{
+    if (config.oneshot)
+    {
+        unsigned long now = millis();
+        if (now - lastRead < ONESHOT_INTERVAL)
+        {
+            return false;
+        }
+        lastRead = now;
+        raw = analogRead(pin);
+        return true;
+    }
+
+    if (!frameReady)
+    {
+        return false;
+    }
+    frameReady = false;
+
+    adc_continuous_data_t *result = NULL;
+    if (!analogContinuousRead(&result, 0))
+    {
+        return false;
+    }
+    raw = result[0].avg_read_raw;
+    return true;
+}
+
+/**
+ * @brief Get the current quantized brightness level
+ *
+ * @return Brightness level (minLevel-maxLevel)
+ */
+uint8_t AmbientLight::getLevel()
+{
+    return level;
+}
+
+/**
+ * @brief Get the filtered ADC reading
+ *
+ * @return Filtered raw value (0-4095)
+ */
+uint16_t AmbientLight::getFiltered()
+{
+    return filtered >> 8;
+}
+
+/**
+ * @brief Quantize a raw reading to a brightness level, without hysteresis
+ *
+ * Linear mapping of [darkRaw, brightRaw] onto [minLevel, maxLevel], rounded
+ * to the nearest level. Works for both divider orientations.
+ */
+uint8_t AmbientLight::levelFor(int32_t raw)
+{
+    int32_t span = (int32_t)config.brightRaw - (int32_t)config.darkRaw;
+    int32_t levels = (int32_t)config.maxLevel - (int32_t)config.minLevel;
+    if (span == 0)
+    {
+        return config.maxLevel;
+    }
+
+    int32_t index = ((raw - (int32_t)config.darkRaw) * levels + span / 2) / span;
+    index = constrain(index, min((int32_t)0, levels), max((int32_t)0, levels));
+    return (uint8_t)(config.minLevel + index);
+}
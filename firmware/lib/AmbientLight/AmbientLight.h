@@ -0,0 +1,120 @@
+#ifndef AMBIENT_LIGHT_H
+#define AMBIENT_LIGHT_H
+
+#include <Arduino.h>
+
+/**
+ * @brief Ambient light configuration
+ *
+ * The LDR is expected in a voltage divider where more light gives a higher
+ * ADC reading (LDR to 3V3, fixed resistor to GND). Swap darkRaw and
+ * brightRaw to use the opposite wiring.
+ */
+typedef struct
+{
+    uint16_t darkRaw;     // ADC reading (0-4095) mapped to minLevel
+    uint16_t brightRaw;   // ADC reading (0-4095) mapped to maxLevel
+    uint8_t minLevel;     // Brightness level in the dark (0-15)
+    uint8_t maxLevel;     // Brightness level in full light (0-15)
+    uint8_t filterShift;  // Low-pass strength, filter time constant is 2^filterShift samples
+    uint16_t hysteresis;  // ADC counts the reading must cross a level boundary by
+    bool oneshot;         // Sample with analogRead() instead of the ADC DMA, which shares I2S0 with the DAC DMA
+} AmbientLightConfig;
+
+/**
+ * @brief AmbientLight class for adapting the eyes brightness to ambient light
+ *
+ * Samples an LDR through the ESP32 ADC in continuous (DMA) mode. Each DMA
+ * frame is averaged by the driver, then fed to a fixed-point low-pass filter.
+ * In oneshot mode (when I2S0 drives the DAC), the pin is read at the same
+ * rate with analogRead() instead.
+ * The filtered value is quantized to a brightness level with hysteresis so
+ * the level does not flicker around a boundary.
+ */
+class AmbientLight
+{
+public:
+    /**
+     * @brief Construct a new AmbientLight object
+     *
+     * @param pin ADC1 capable pin connected to the LDR divider
+     */
+    AmbientLight(uint8_t pin);
+
+    /**
+     * @brief Start sampling
+     *
+     * @param config Mapping, filter and hysteresis settings
+     *
+     * @return true if the ADC continuous driver was started (always in oneshot mode)
+     */
+    bool begin(const AmbientLightConfig &config);
+
+    /**
+     * @brief Consume pending ADC frames (call this in loop())
+     *
+     * Never blocks: returns immediately when no DMA frame is ready (or, in
+     * oneshot mode, when the next reading is not due).
+     *
+     * @return true if the quantized brightness level changed, or on the
+     *         first reading (the level is only known from then on)
+     */
+    bool update();
+
+    /**
+     * @brief Get the current quantized brightness level
+     *
+     * @return Brightness level (minLevel-maxLevel)
+     */
+    uint8_t getLevel();
+
+    /**
+     * @brief Get the filtered ADC reading
+     *
+     * @return Filtered raw value (0-4095)
+     */
+    uint16_t getFiltered();
+
+private:
+    uint8_t pin;
+    AmbientLightConfig config;
+    bool running;
+
+    // Filtered reading in Q8 fixed point (raw << 8)
+    uint32_t filtered;
+    bool primed;
+    uint8_t level;
+    unsigned long lastRead; // Oneshot mode: millis() of the last reading
+
+    // Set from the ADC ISR when a conversion frame is complete
+    static volatile bool frameReady;
+
+    static const uint32_t SAMPLING_FREQUENCY = 20000; // Hz, lowest rate supported by the ESP32 ADC DMA
+    static const uint32_t CONVERSIONS_PER_FRAME = 256; // Samples averaged by the driver per frame
+    static const uint32_t ONESHOT_INTERVAL = 13; // ms, about the DMA frame rate so the filter keeps its time constant
+
+    /**
+     * @brief ADC continuous mode conversion-done callback (ISR context)
+     */
+    static void onFrame();
+
+    /**
+     * @brief Get the next raw reading if one is ready
+     *
+     * @param raw Reading (0-4095)
+     *
+     * @return true if a reading was taken
+     */
+    bool read(uint32_t &raw);
+
+    /**
+     * @brief Quantize a raw reading to a brightness level, without hysteresis
+     *
+     * @param raw ADC reading, may be out of the dark/bright range
+     *
+     * @return Brightness level (minLevel-maxLevel)
+     */
+    uint8_t levelFor(int32_t raw);
+};
+
+#endif // AMBIENT_LIGHT_H
@@ -0,0 +1,37 @@
+#include "AssetPack.h"
+#include <esp_partition.h>
+
+AssetPack::AssetPack() : AssetPackReader()
+{
+}
+
+/**
+ * @brief Map the assets partition and check the pack
+ *
+ * The mapping is kept for the lifetime of the program: the pointers handed
+ * out by the getters stay valid.
+ *
+ * @return false if there is no valid pack, the built-in assets are used
+ */
+bool AssetPack::begin()
+{
+    const esp_partition_t *partition = esp_partition_find_first(
+        ESP_PARTITION_TYPE_DATA, (esp_partition_subtype_t)ASSET_PACK_PARTITION_SUBTYPE, ASSET_PACK_PARTITION);
+    if (partition == NULL)
+    {
+        return false;
+    }
+
+    const void *mapped = NULL;
+    esp_partition_mmap_handle_t mapping;
+    if (esp_partition_mmap(partition, 0, partition->size, ESP_PARTITION_MMAP_DATA, &mapped, &mapping) != ESP_OK)
+    {
+        return false;
+    }
+    if (!open((const uint8_t *)mapped, partition->size))
+    {
+        esp_partition_munmap(mapping);
+        return false;
+    }
+    return true;
+}
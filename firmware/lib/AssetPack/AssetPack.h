@@ -0,0 +1,32 @@
+#ifndef ASSET_PACK_H
+#define ASSET_PACK_H
+
+#include <Arduino.h>
+#include "AssetPackFormat.h"
+
+// Data partition holding the pack (see partitions.csv)
+#define ASSET_PACK_PARTITION "assets"
+#define ASSET_PACK_PARTITION_SUBTYPE 0x41
+
+/**
+ * @brief AssetPack class, the asset pack of the assets partition
+ *
+ * The partition is memory-mapped and read in place through the flash cache:
+ * assets are updated without reflashing the firmware, and RAM use does not
+ * depend on the size of the pack. Each asset missing from the pack (or the
+ * whole pack) falls back on the built-in one.
+ */
+class AssetPack : public AssetPackReader
+{
+public:
+    AssetPack();
+
+    /**
+     * @brief Map the assets partition and check the pack
+     *
+     * @return false if there is no valid pack, the built-in assets are used
+     */
+    bool begin();
+};
+
+#endif // ASSET_PACK_H
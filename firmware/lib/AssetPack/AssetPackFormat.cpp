@@ -0,0 +1,232 @@
+#include "AssetPackFormat.h"
+
+/**
+ * @brief CRC-32 (IEEE 802.3, as zlib), bitwise
+ *
+ * @return CRC of the bytes
+ */
+uint32_t assetPackCrc32(const uint8_t *data, size_t length)
+{
+    uint32_t crc = 0xFFFFFFFF;
+    for (size_t i = 0; i < length; i++)
+    {
+        crc ^= data[i];
+        for (uint8_t bit = 0; bit < 8; bit++)
+        {
+            crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
+
+AssetPackReader::AssetPackReader()
+{
+    data = NULL;
+    sections = NULL;
+    sectionCount = 0;
+}
+
+/**
+ * @brief Check a pack and start using it
+ *
+ * Checks the header, the CRC and that every section is aligned and inside
+ * the pack, so that find() can hand out pointers without further checks.
+ *
+ * @return false if it is not a valid pack of this version
+ */
+bool AssetPackReader::open(const uint8_t *data, uint32_t capacity)
+{
+    this->data = NULL;
+    sections = NULL;
+    sectionCount = 0;
+
+    if (data == NULL || capacity < sizeof(AssetPackHeader))
+    {
+        return false;
+    }
+    const AssetPackHeader *header = (const AssetPackHeader *)data;
+    if (header->magic != ASSET_PACK_MAGIC || header->version != ASSET_PACK_VERSION ||
+        header->size > capacity ||
+        header->size < sizeof(AssetPackHeader) + (uint32_t)header->sectionCount * sizeof(AssetSection))
+    {
+        return false;
+    }
+    if (assetPackCrc32(data + sizeof(AssetPackHeader), header->size - sizeof(AssetPackHeader)) != header->crc32)
+    {
+        return false;
+    }
+
+    const AssetSection *table = (const AssetSection *)(header + 1);
+    for (uint16_t i = 0; i < header->sectionCount; i++)
+    {
+        if (table[i].offset % ASSET_PACK_ALIGN != 0 || table[i].offset > header->size ||
+            table[i].size > header->size - table[i].offset)
+        {
+            return false;
+        }
+    }
+
+    this->data = data;
+    sections = table;
+    sectionCount = header->sectionCount;
+    return true;
+}
+
+/**
+ * @brief Check if a valid pack is open
+ */
+bool AssetPackReader::isOpen() const
+{
+    return data != NULL;
+}
+
+/**
+ * @brief Find a section
+ *
+ * @return Start of the section, NULL if the pack has none of this type
+ */
+const uint8_t *AssetPackReader::find(uint16_t type, uint16_t &count, uint32_t &size) const
+{
+    for (uint16_t i = 0; i < sectionCount; i++)
+    {
+        if (sections[i].type == type)
+        {
+            count = sections[i].count;
+            size = sections[i].size;
+            return data + sections[i].offset;
+        }
+    }
+    count = 0;
+    size = 0;
+    return NULL;
+}
+
+/**
+ * @brief Find a section of count fixed-size entries
+ *
+ * @return Start of the section, NULL if missing or if its size does not
+ *         match count x entrySize
+ */
+const uint8_t *AssetPackReader::findArray(uint16_t type, size_t entrySize, uint16_t &count) const
+{
+    uint32_t size = 0;
+    const uint8_t *section = find(type, count, size);
+    if (section == NULL || count == 0 || size != count * entrySize)
+    {
+        count = 0;
+        return NULL;
+    }
+    return section;
+}
+
+/**
+ * @brief Get the eye shape
+ *
+ * @return 8 column bytes, NULL if missing
+ */
+const uint8_t *AssetPackReader::eyeShape() const
+{
+    uint16_t count = 0;
+    const uint8_t *shape = findArray(ASSET_EYE_SHAPE, 1, count);
+    return count == 8 ? shape : NULL;
+}
+
+/**
+ * @brief Get the gaze positions
+ *
+ * @return Positions, NULL if missing
+ */
+const AssetPosition *AssetPackReader::gazePositions(uint16_t &count) const
+{
+    return (const AssetPosition *)findArray(ASSET_GAZE_POSITIONS, sizeof(AssetPosition), count);
+}
+
+/**
+ * @brief Get the font
+ *
+ * @return Font header, NULL if missing or truncated
+ */
+const AssetFont *AssetPackReader::font(const uint8_t *&glyphs) const
+{
+    uint16_t count = 0;
+    uint32_t size = 0;
+    const AssetFont *header = (const AssetFont *)find(ASSET_FONT, count, size);
+    if (header == NULL || size < sizeof(AssetFont) || header->last < header->first || header->width == 0 ||
+        size - sizeof(AssetFont) < (uint32_t)(header->last - header->first + 1) * header->width)
+    {
+        return NULL;
+    }
+    glyphs = (const uint8_t *)(header + 1);
+    return header;
+}
+
+/**
+ * @brief Get the sound folders
+ *
+ * @return Sound folders, NULL if missing
+ */
+const AssetSounds *AssetPackReader::sounds() const
+{
+    uint16_t count = 0;
+    const AssetSounds *sounds = (const AssetSounds *)findArray(ASSET_SOUNDS, sizeof(AssetSounds), count);
+    return count == 1 ? sounds : NULL;
+}
+
+/**
+ * @brief Get the scenes
+ *
+ * @return Scenes, NULL if missing or invalid
+ */
+const AssetScene *AssetPackReader::scenes(uint16_t &count, const AssetSceneEvent *&events) const
+{
+    uint16_t eventCount = 0;
+    events = (const AssetSceneEvent *)findArray(ASSET_SCENE_EVENTS, sizeof(AssetSceneEvent), eventCount);
+    const AssetScene *scenes = (const AssetScene *)findArray(ASSET_SCENES, sizeof(AssetScene), count);
+    if (scenes == NULL || events == NULL)
+    {
+        count = 0;
+        return NULL;
+    }
+
+    for (uint16_t i = 0; i < count; i++)
+    {
+        if (memchr(scenes[i].name, '\0', ASSET_SCENE_NAME_SIZE) == NULL ||
+            (uint32_t)scenes[i].firstEvent + scenes[i].eventCount > eventCount)
+        {
+            count = 0;
+            return NULL;
+        }
+    }
+    return scenes;
+}
+
+/**
+ * @brief Get the messages
+ *
+ * @return First message, NULL if missing or not terminated
+ */
+const char *AssetPackReader::messages(uint16_t &count) const
+{
+    uint32_t size = 0;
+    const char *text = (const char *)find(ASSET_MESSAGES, count, size);
+    if (text == NULL)
+    {
+        return NULL;
+    }
+
+    // Exactly count terminators, the last one at the end
+    uint16_t terminators = 0;
+    for (uint32_t i = 0; i < size; i++)
+    {
+        if (text[i] == '\0')
+        {
+            terminators++;
+        }
+    }
+    if (count == 0 || terminators != count || text[size - 1] != '\0')
+    {
+        count = 0;
+        return NULL;
+    }
+    return text;
+}
@@ -0,0 +1,215 @@
+#ifndef ASSET_PACK_FORMAT_H
+#define ASSET_PACK_FORMAT_H
+
+// Pure C++ (no Arduino dependency) so it can be tested on the host
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+// Layout of the assets partition, written by tools/asset_pack.py:
+// AssetPackHeader, sectionCount x AssetSection, then the sections. Little
+// endian, sections aligned on ASSET_PACK_ALIGN bytes, offsets from the start
+// of the pack. The CRC covers everything after the header.
+
+#define ASSET_PACK_MAGIC 0x50414B53 // "SKAP"
+#define ASSET_PACK_VERSION 1
+#define ASSET_PACK_ALIGN 4
+
+/**
+ * @brief Section types, unknown ones are skipped
+ */
+enum AssetType
+{
+    ASSET_EYE_SHAPE = 1,      // count x uint8_t (8): open eye pixels, one byte per display column
+    ASSET_GAZE_POSITIONS = 2, // count x AssetPosition: iris coordinates of each GazePosition
+    ASSET_FONT = 3,           // AssetFont, then (last - first + 1) x width column bytes
+    ASSET_SOUNDS = 4,         // AssetSounds: sound folders and number of tracks
+    ASSET_SCENES = 5,         // count x AssetScene
+    ASSET_SCENE_EVENTS = 6,   // count x AssetSceneEvent, the events of all scenes
+    ASSET_MESSAGES = 7,       // count NUL-terminated strings, back to back
+};
+
+typedef struct
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t sectionCount;
+    uint32_t size;  // Whole pack (bytes)
+    uint32_t crc32; // CRC-32 (IEEE) of the bytes after the header
+} AssetPackHeader;
+
+typedef struct
+{
+    uint16_t type;  // AssetType
+    uint16_t count; // Number of entries
+    uint32_t offset;
+    uint32_t size;  // Bytes
+} AssetSection;
+
+typedef struct
+{
+    uint8_t x;
+    uint8_t y;
+} AssetPosition;
+
+typedef struct
+{
+    uint8_t first; // First character
+    uint8_t last;  // Last character
+    uint8_t width; // Columns per glyph, bit 0 is the top row
+    uint8_t reserved;
+} AssetFont;
+
+typedef struct
+{
+    uint8_t yawningFolder;
+    uint8_t speechFolder;
+    uint8_t effectFolder;
+    uint8_t yawningNbSounds;
+    uint8_t speechNbSounds;
+    uint8_t effectNbSounds;
+    uint8_t reserved[2];
+} AssetSounds;
+
+#define ASSET_SCENE_NAME_SIZE 12
+
+typedef struct
+{
+    char name[ASSET_SCENE_NAME_SIZE]; // NUL-terminated
+    uint16_t firstEvent;              // Index in ASSET_SCENE_EVENTS
+    uint8_t eventCount;
+    uint8_t reserved;
+} AssetScene;
+
+// Same layout as SceneEvent, so events are played in place
+typedef struct
+{
+    uint16_t atMs;
+    uint8_t type;
+    uint8_t a;
+    uint8_t b;
+    uint8_t reserved;
+} AssetSceneEvent;
+
+static_assert(sizeof(AssetPackHeader) == 16, "AssetPackHeader layout");
+static_assert(sizeof(AssetSection) == 12, "AssetSection layout");
+static_assert(sizeof(AssetScene) == 16, "AssetScene layout");
+static_assert(sizeof(AssetSceneEvent) == 6, "AssetSceneEvent layout");
+
+/**
+ * @brief CRC-32 (IEEE 802.3, as zlib), bitwise: no table in RAM or flash
+ *
+ * @param data Bytes to check
+ * @param length Number of bytes
+ *
+ * @return CRC of the bytes
+ */
+uint32_t assetPackCrc32(const uint8_t *data, size_t length);
+
+/**
+ * @brief Read-only view of an asset pack, validated once
+ *
+ * Works on the pack where it is (e.g. memory-mapped flash): nothing is
+ * copied, the sections are returned as pointers into it.
+ */
+class AssetPackReader
+{
+public:
+    AssetPackReader();
+
+    /**
+     * @brief Check a pack and start using it
+     *
+     * @param data Start of the pack, must stay valid while in use
+     * @param capacity Bytes available at data (e.g. partition size)
+     *
+     * @return false if it is not a valid pack of this version
+     */
+    bool open(const uint8_t *data, uint32_t capacity);
+
+    /**
+     * @brief Check if a valid pack is open
+     */
+    bool isOpen() const;
+
+    /**
+     * @brief Find a section
+     *
+     * @param type AssetType
+     * @param count Number of entries of the section
+     * @param size Size of the section (bytes)
+     *
+     * @return Start of the section, NULL if the pack has none of this type
+     */
+    const uint8_t *find(uint16_t type, uint16_t &count, uint32_t &size) const;
+
+    /**
+     * @brief Find a section of count fixed-size entries
+     *
+     * @return Start of the section, NULL if missing or if its size does not
+     *         match count x entrySize
+     */
+    const uint8_t *findArray(uint16_t type, size_t entrySize, uint16_t &count) const;
+
+    /**
+     * @brief Get the eye shape
+     *
+     * @return 8 column bytes, NULL if missing
+     */
+    const uint8_t *eyeShape() const;
+
+    /**
+     * @brief Get the gaze positions
+     *
+     * @param count Number of positions
+     *
+     * @return Positions, NULL if missing
+     */
+    const AssetPosition *gazePositions(uint16_t &count) const;
+
+    /**
+     * @brief Get the font
+     *
+     * @param glyphs Column bytes of the glyphs, first character first
+     *
+     * @return Font header, NULL if missing or truncated
+     */
+    const AssetFont *font(const uint8_t *&glyphs) const;
+
+    /**
+     * @brief Get the sound folders
+     *
+     * @return Sound folders, NULL if missing
+     */
+    const AssetSounds *sounds() const;
+
+    /**
+     * @brief Get the scenes
+     *
+     * Names are checked to be terminated and events to be in range.
+     *
+     * @param count Number of scenes
+     * @param events Events of all scenes, see AssetScene::firstEvent
+     *
+     * @return Scenes, NULL if missing or invalid
+     */
+    const AssetScene *scenes(uint16_t &count, const AssetSceneEvent *&events) const;
+
+    /**
+     * @brief Get the messages
+     *
+     * @param count Number of messages
+     *
+     * @return First message, the next ones follow their terminator. NULL if
+     *         missing or not terminated
+     */
+    const char *messages(uint16_t &count) const;
+
+private:
+    const uint8_t *data;
+    const AssetSection *sections;
+    uint16_t sectionCount;
+};
+
+#endif // ASSET_PACK_FORMAT_H
@@ -0,0 +1,178 @@
+#include "Behavior.h"
+
+const BehaviorPosition behaviorPositions[GAZE_POSITION_COUNT] = {
+    {3, 6}, // GAZE_TOP
+    {3, 0}, // GAZE_BOTTOM
+    {0, 3}, // GAZE_LEFT
+    {6, 3}, // GAZE_RIGHT
+    {3, 3}, // GAZE_CENTER
+    {1, 5}, // GAZE_TOP_LEFT
+    {5, 5}, // GAZE_TOP_RIGHT
+    {1, 1}, // GAZE_BOTTOM_LEFT
+    {5, 1}, // GAZE_BOTTOM_RIGHT
+    {4, 3}, // GAZE_CENTER_LEFT
+    {2, 3}, // GAZE_CENTER_RIGHT
+    {3, 4}, // GAZE_TOP_CENTER
+    {3, 2}  // GAZE_BOTTOM_CENTER
+};
+
+/**
+ * @brief Construct a new Behavior object
+ *
+ * @param personality Transition table, must outlive the object
+ */
+Behavior::Behavior(const BehaviorPersonality &personality)
+    : personality(personality)
+{
+    state = BEHAVIOR_IDLE_GAZE;
+}
+
+/**
+ * @brief Build the alias tables
+ *
+ * O(n) per distribution, done once so that next() is O(1).
+ */
+void Behavior::begin()
+{
+    for (uint8_t i = 0; i < BEHAVIOR_STATE_COUNT; i++)
+    {
+        const BehaviorStateTable &row = personality.states[i];
+        build(tables[i].next, row.next, BEHAVIOR_STATE_COUNT);
+        build(tables[i].positions, row.positions, GAZE_POSITION_COUNT);
+        build(tables[i].dwells, row.dwellWeights, BEHAVIOR_DWELL_COUNT);
+    }
+}
+
+/**
+ * @brief Move to the next state
+ *
+ * @return The new state, its gaze target and dwell time
+ */
+BehaviorDecision Behavior::next()
+{
+    uint8_t nextState = sample(tables[state].next);
+    if (nextState != NONE)
+    {
+        state = (BehaviorState)nextState;
+    }
+
+    BehaviorDecision decision;
+    decision.state = state;
+
+    uint8_t position = sample(tables[state].positions);
+    decision.position = (position == NONE) ? -1 : position;
+
+    decision.dwellMs = 0;
+    uint8_t bucket = sample(tables[state].dwells);
+    if (bucket != NONE)
+    {
+        const BehaviorDwell &dwell = personality.states[state].dwells[bucket];
+        decision.dwellMs = random(dwell.minMs, dwell.maxMs + 1);
+    }
+    return decision;
+}
+
+/**
+ * @brief Get the current state
+ */
+BehaviorState Behavior::getState()
+{
+    return state;
+}
+
+/**
+ * @brief Get the personality name
+ */
+const char *Behavior::getName()
+{
+    return personality.name;
+}
+
+/**
+ * @brief Build an alias table from weights (Vose's algorithm)
+ *
+ * Each outcome is scaled so that the average is 1.0 (65536 in Q16). Columns
+ * below average are topped up with the excess of a column above average,
+ * which becomes their alias. Every column ends up holding at most two
+ * outcomes.
+ */
+void Behavior::build(AliasTable &table, const uint16_t *weights, uint8_t count)
+{
+    uint32_t sum = 0;
+    for (uint8_t i = 0; i < count; i++)
+    {
+        sum += weights[i];
+    }
+    if (sum == 0)
+    {
+        table.count = 0;
+        return;
+    }
+    table.count = count;
+
+    uint32_t scaled[BEHAVIOR_ALIAS_SIZE];
+    uint8_t small[BEHAVIOR_ALIAS_SIZE];
+    uint8_t large[BEHAVIOR_ALIAS_SIZE];
+    uint8_t nbSmall = 0;
+    uint8_t nbLarge = 0;
+
+    for (uint8_t i = 0; i < count; i++)
+    {
+        scaled[i] = (uint64_t)weights[i] * count * 65536 / sum;
+        if (scaled[i] < 65536)
+        {
+            small[nbSmall++] = i;
+        }
+        else
+        {
+            large[nbLarge++] = i;
+        }
+    }
+
+    while (nbSmall > 0 && nbLarge > 0)
+    {
+        uint8_t s = small[--nbSmall];
+        uint8_t l = large[--nbLarge];
+        table.prob[s] = scaled[s];
+        table.alias[s] = l;
+        scaled[l] = scaled[l] + scaled[s] - 65536;
+        if (scaled[l] < 65536)
+        {
+            small[nbSmall++] = l;
+        }
+        else
+        {
+            large[nbLarge++] = l;
+        }
+    }
+
+    // Leftovers are full columns (or off by rounding): always keep them
+    while (nbLarge > 0)
+    {
+        uint8_t l = large[--nbLarge];
+        table.prob[l] = 0xFFFF;
+        table.alias[l] = l;
+    }
+    while (nbSmall > 0)
+    {
+        uint8_t s = small[--nbSmall];
+        table.prob[s] = 0xFFFF;
+        table.alias[s] = s;
+    }
+}
+
+/**
+ * @brief Sample an alias table in O(1)
+ *
+ * @return Outcome index, or NONE if the table is empty
+ */
+uint8_t Behavior::sample(const AliasTable &table)
+{
+    if (table.count == 0)
+    {
+        return NONE;
+    }
+    uint8_t column = random(0, table.count);
+    uint16_t coin = random(0, 65536);
+    return (coin < table.prob[column]) ? column : table.alias[column];
+}
@@ -0,0 +1,176 @@
+#ifndef BEHAVIOR_H
+#define BEHAVIOR_H
+
+#include <Arduino.h>
+
+/**
+ * @brief Behavior states
+ */
+enum BehaviorState
+{
+    BEHAVIOR_IDLE_GAZE,   // Eyes open, looking somewhere
+    BEHAVIOR_BLINK,       // Eyes closed briefly
+    BEHAVIOR_YAWN,        // Eyes closed with a yawning sound
+    BEHAVIOR_LOOK_AROUND, // Quick gaze moves
+    BEHAVIOR_STARE,       // Eyes open, gaze fixed for a long time
+    BEHAVIOR_STATE_COUNT
+};
+
+/**
+ * @brief Gaze targets, indexes in behaviorPositions
+ */
+enum GazePosition
+{
+    GAZE_TOP,
+    GAZE_BOTTOM,
+    GAZE_LEFT,
+    GAZE_RIGHT,
+    GAZE_CENTER,
+    GAZE_TOP_LEFT,
+    GAZE_TOP_RIGHT,
+    GAZE_BOTTOM_LEFT,
+    GAZE_BOTTOM_RIGHT,
+    GAZE_CENTER_LEFT,
+    GAZE_CENTER_RIGHT,
+    GAZE_TOP_CENTER,
+    GAZE_BOTTOM_CENTER,
+    GAZE_POSITION_COUNT
+};
+
+// Number of dwell time buckets per state
+#define BEHAVIOR_DWELL_COUNT 4
+// Largest distribution an alias table can sample from
+#define BEHAVIOR_ALIAS_SIZE GAZE_POSITION_COUNT
+
+/**
+ * @brief Iris coordinates of a gaze target
+ */
+typedef struct
+{
+    uint8_t x;
+    uint8_t y;
+} BehaviorPosition;
+
+/**
+ * @brief Dwell time bucket, the actual time is uniform within the bucket
+ */
+typedef struct
+{
+    uint16_t minMs;
+    uint16_t maxMs;
+} BehaviorDwell;
+
+/**
+ * @brief Row of the transition table: what happens in, and after, a state
+ *
+ * Weights are relative, they do not need to sum to any particular value.
+ * A state with all position weights at 0 keeps the current gaze.
+ */
+typedef struct
+{
+    uint16_t next[BEHAVIOR_STATE_COUNT];         // Weights of the next state
+    uint16_t positions[GAZE_POSITION_COUNT];     // Weights of the gaze target
+    BehaviorDwell dwells[BEHAVIOR_DWELL_COUNT];  // Dwell time buckets
+    uint16_t dwellWeights[BEHAVIOR_DWELL_COUNT]; // Weights of the dwell buckets
+} BehaviorStateTable;
+
+/**
+ * @brief A personality: the full transition table, kept in flash
+ */
+typedef struct
+{
+    const char *name;
+    BehaviorStateTable states[BEHAVIOR_STATE_COUNT];
+} BehaviorPersonality;
+
+/**
+ * @brief Decision taken when entering a new state
+ */
+typedef struct
+{
+    BehaviorState state;
+    int8_t position;  // GazePosition, or -1 to keep the current gaze
+    uint32_t dwellMs; // Time to stay in the state once its animation is done
+} BehaviorDecision;
+
+// Iris coordinates of each GazePosition
+extern const BehaviorPosition behaviorPositions[GAZE_POSITION_COUNT];
+
+/**
+ * @brief Behavior class, a table-driven Markov chain of eye behaviors
+ *
+ * Every weighted pick (next state, gaze target, dwell bucket) uses Vose's
+ * alias method: the tables are built once in begin(), then each sample is
+ * one uniform index and one biased coin flip, O(1) whatever the table size.
+ */
+class Behavior
+{
+public:
+    /**
+     * @brief Construct a new Behavior object
+     *
+     * @param personality Transition table, must outlive the object
+     */
+    Behavior(const BehaviorPersonality &personality);
+
+    /**
+     * @brief Build the alias tables
+     * Must be called in setup() before next()
+     */
+    void begin();
+
+    /**
+     * @brief Move to the next state
+     *
+     * @return The new state, its gaze target and dwell time
+     */
+    BehaviorDecision next();
+
+    /**
+     * @brief Get the current state
+     */
+    BehaviorState getState();
+
+    /**
+     * @brief Get the personality name
+     */
+    const char *getName();
+
+private:
+    /**
+     * @brief Alias table for one discrete distribution
+     */
+    struct AliasTable
+    {
+        uint16_t prob[BEHAVIOR_ALIAS_SIZE]; // Q16 probability to keep the column
+        uint8_t alias[BEHAVIOR_ALIAS_SIZE]; // Outcome when not kept
+        uint8_t count;                      // Number of outcomes, 0 if all weights are 0
+    };
+
+    struct StateTables
+    {
+        AliasTable next;
+        AliasTable positions;
+        AliasTable dwells;
+    };
+
+    const BehaviorPersonality &personality;
+    StateTables tables[BEHAVIOR_STATE_COUNT];
+    BehaviorState state;
+
+    static const uint8_t NONE = 0xFF;
+
+    /**
+     * @brief Build an alias table from weights (Vose's algorithm)
+     */
+    static void build(AliasTable &table, const uint16_t *weights, uint8_t count);
+
+    /**
+     * @brief Sample an alias table in O(1)
+     *
+     * @return Outcome index, or NONE if the table is empty
+     */
+    static uint8_t sample(const AliasTable &table);
+};
+
+#endif // BEHAVIOR_H
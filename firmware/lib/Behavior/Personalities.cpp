@@ -0,0 +1,131 @@
+#include "Personalities.h"
+
+// Row layout, see BehaviorStateTable:
+//   next:      IDLE_GAZE, BLINK, YAWN, LOOK_AROUND, STARE
+//   positions: TOP, BOTTOM, LEFT, RIGHT, CENTER,
+//              TOP_LEFT, TOP_RIGHT, BOTTOM_LEFT, BOTTOM_RIGHT,
+//              CENTER_LEFT, CENTER_RIGHT, TOP_CENTER, BOTTOM_CENTER
+//   dwells:    4 buckets {minMs, maxMs}, then their weights
+
+const BehaviorPersonality personalityClassic = {
+    .name = "classic",
+    .states = {
+        // BEHAVIOR_IDLE_GAZE
+        {
+            .next = {90, 0, 10, 0, 0},
+            .positions = {1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1},
+            .dwells = {{1000, 5000}, {0, 0}, {0, 0}, {0, 0}},
+            .dwellWeights = {1, 0, 0, 0},
+        },
+        // BEHAVIOR_BLINK (not reached)
+        {
+            .next = {1, 0, 0, 0, 0},
+            .positions = {0},
+            .dwells = {{100, 200}, {0, 0}, {0, 0}, {0, 0}},
+            .dwellWeights = {1, 0, 0, 0},
+        },
+        // BEHAVIOR_YAWN
+        {
+            .next = {1, 0, 0, 0, 0},
+            .positions = {0},
+            .dwells = {{3000, 6000}, {0, 0}, {0, 0}, {0, 0}},
+            .dwellWeights = {1, 0, 0, 0},
+        },
+        // BEHAVIOR_LOOK_AROUND (not reached)
+        {
+            .next = {1, 0, 0, 0, 0},
+            .positions = {1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1},
+            .dwells = {{300, 800}, {0, 0}, {0, 0}, {0, 0}},
+            .dwellWeights = {1, 0, 0, 0},
+        },
+        // BEHAVIOR_STARE (not reached)
+        {
+            .next = {1, 0, 0, 0, 0},
+            .positions = {0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0},
+            .dwells = {{5000, 10000}, {0, 0}, {0, 0}, {0, 0}},
+            .dwellWeights = {1, 0, 0, 0},
+        },
+    },
+};
+
+const BehaviorPersonality personalitySleepy = {
+    .name = "sleepy",
+    .states = {
+        // BEHAVIOR_IDLE_GAZE
+        {
+            .next = {60, 15, 15, 0, 10},
+            .positions = {1, 4, 2, 2, 4, 1, 1, 4, 4, 2, 2, 1, 4},
+            .dwells = {{2000, 4000}, {4000, 8000}, {8000, 12000}, {0, 0}},
+            .dwellWeights = {3, 2, 1, 0},
+        },
+        // BEHAVIOR_BLINK
+        {
+            .next = {80, 10, 0, 0, 10},
+            .positions = {0},
+            .dwells = {{150, 300}, {400, 800}, {0, 0}, {0, 0}},
+            .dwellWeights = {3, 1, 0, 0},
+        },
+        // BEHAVIOR_YAWN
+        {
+            .next = {70, 20, 10, 0, 0},
+            .positions = {0},
+            .dwells = {{3000, 6000}, {6000, 10000}, {0, 0}, {0, 0}},
+            .dwellWeights = {2, 1, 0, 0},
+        },
+        // BEHAVIOR_LOOK_AROUND (not reached)
+        {
+            .next = {1, 0, 0, 0, 0},
+            .positions = {0, 1, 1, 1, 0, 0, 0, 1, 1, 0, 0, 0, 1},
+            .dwells = {{800, 1500}, {0, 0}, {0, 0}, {0, 0}},
+            .dwellWeights = {1, 0, 0, 0},
+        },
+        // BEHAVIOR_STARE
+        {
+            .next = {70, 30, 0, 0, 0},
+            .positions = {0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0},
+            .dwells = {{6000, 12000}, {0, 0}, {0, 0}, {0, 0}},
+            .dwellWeights = {1, 0, 0, 0},
+        },
+    },
+};
+
+const BehaviorPersonality personalityNervous = {
+    .name = "nervous",
+    .states = {
+        // BEHAVIOR_IDLE_GAZE
+        {
+            .next = {30, 25, 3, 35, 7},
+            .positions = {1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1},
+            .dwells = {{400, 1200}, {1200, 2500}, {0, 0}, {0, 0}},
+            .dwellWeights = {3, 1, 0, 0},
+        },
+        // BEHAVIOR_BLINK
+        {
+            .next = {50, 10, 0, 40, 0},
+            .positions = {0},
+            .dwells = {{80, 150}, {0, 0}, {0, 0}, {0, 0}},
+            .dwellWeights = {1, 0, 0, 0},
+        },
+        // BEHAVIOR_YAWN
+        {
+            .next = {1, 0, 0, 0, 0},
+            .positions = {0},
+            .dwells = {{2000, 3000}, {0, 0}, {0, 0}, {0, 0}},
+            .dwellWeights = {1, 0, 0, 0},
+        },
+        // BEHAVIOR_LOOK_AROUND
+        {
+            .next = {20, 15, 0, 60, 5},
+            .positions = {2, 2, 4, 4, 1, 3, 3, 3, 3, 1, 1, 1, 1},
+            .dwells = {{150, 400}, {400, 700}, {0, 0}, {0, 0}},
+            .dwellWeights = {2, 1, 0, 0},
+        },
+        // BEHAVIOR_STARE
+        {
+            .next = {20, 40, 0, 40, 0},
+            .positions = {0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0},
+            .dwells = {{2000, 4000}, {0, 0}, {0, 0}, {0, 0}},
+            .dwellWeights = {1, 0, 0, 0},
+        },
+    },
+};
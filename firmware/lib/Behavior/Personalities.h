@@ -0,0 +1,16 @@
+#ifndef PERSONALITIES_H
+#define PERSONALITIES_H
+
+#include "Behavior.h"
+
+// Behaves like the original fixed logic: random gaze every 1-5s,
+// 10% chance to close the eyes (with a yawn) for 3-6s
+extern const BehaviorPersonality personalityClassic;
+
+// Long dwell times, frequent blinks and yawns, gaze mostly low
+extern const BehaviorPersonality personalitySleepy;
+
+// Short dwell times, looks around a lot, quick blinks
+extern const BehaviorPersonality personalityNervous;
+
+#endif // PERSONALITIES_H
@@ -0,0 +1,308 @@
+#include "Choreography.h"
+
+Choreography::Choreography()
+{
+    size = 0;
+    nextSeq = 0;
+    handler = NULL;
+    scene = NULL;
+    cursor = 0;
+    sceneEntries = 0;
+    baseUs = 0;
+    waiting = false;
+    waitStartUs = 0;
+    maxLatenessUs = 0;
+}
+
+/**
+ * @brief Set the event handler
+ */
+void Choreography::begin(SceneHandler handler)
+{
+    this->handler = handler;
+}
+
+/**
+ * @brief Start a scene, replacing the one in progress if any
+ */
+void Choreography::start(const Scene &scene)
+{
+    stop();
+    // Scenes may be built on the fly (e.g. from an asset pack): keep a copy
+    current = scene;
+    this->scene = &current;
+    cursor = 0;
+    baseUs = micros();
+    pushSegment();
+}
+
+/**
+ * @brief Stop the scene in progress, one-off events are kept
+ */
+void Choreography::stop()
+{
+    removeSceneEvents();
+    scene = NULL;
+    waiting = false;
+}
+
+/**
+ * @brief Schedule a one-off event, outside of any scene
+ *
+ * @return true if scheduled, false if the queue is full
+ */
+bool Choreography::schedule(const SceneEvent &event, uint32_t dueUs)
+{
+    return push(event, dueUs, false);
+}
+
+/**
+ * @brief Fire the events that are due
+ */
+void Choreography::update()
+{
+    uint32_t now = micros();
+
+    if (waiting)
+    {
+        uint32_t timeout = waitEvent.b ? waitEvent.b : DEFAULT_WAIT_TIMEOUT;
+        if (!handler(waitEvent) && now - waitStartUs < timeout * 1000000UL)
+        {
+            return; // Sound still playing
+        }
+        // Following events are timed from the end of the wait
+        waiting = false;
+        baseUs = now - (uint32_t)waitEvent.atMs * 1000;
+        pushSegment();
+    }
+
+    while (size > 0 && (int32_t)(heap[0].dueUs - now) <= 0)
+    {
+        PendingEvent pending;
+        pop(pending);
+
+        uint32_t lateness = now - pending.dueUs;
+        if (lateness > maxLatenessUs)
+        {
+            maxLatenessUs = lateness;
+        }
+
+        if (pending.fromScene)
+        {
+            sceneEntries--;
+        }
+
+        if (pending.event.type == SCENE_WAIT_TRACK_END)
+        {
+            if (pending.fromScene && !handler(pending.event))
+            {
+                waiting = true;
+                waitEvent = pending.event;
+                waitStartUs = now;
+                return;
+            }
+            if (pending.fromScene)
+            {
+                baseUs = now - (uint32_t)pending.event.atMs * 1000;
+                pushSegment();
+            }
+            continue;
+        }
+
+        handler(pending.event);
+        now = micros();
+    }
+
+    // Top up the heap if the segment did not fit, unless its wait is pending
+    if (scene != NULL && cursor < scene->count &&
+        (cursor == 0 || scene->events[cursor - 1].type != SCENE_WAIT_TRACK_END))
+    {
+        pushSegment();
+    }
+
+    if (scene != NULL && cursor >= scene->count && sceneEntries == 0 && !waiting)
+    {
+        scene = NULL; // Scene complete
+    }
+}
+
+/**
+ * @brief Check if a scene is in progress
+ */
+bool Choreography::isRunning()
+{
+    return scene != NULL;
+}
+
+/**
+ * @brief Get the scene in progress
+ */
+const Scene *Choreography::getScene()
+{
+    return scene;
+}
+
+/**
+ * @brief Time until the next event is due
+ */
+uint32_t Choreography::timeUntilNext()
+{
+    if (waiting)
+    {
+        // Nothing fires until the sound ends: poll for it, or wake up for
+        // the timeout if sooner
+        uint32_t timeout = (waitEvent.b ? waitEvent.b : DEFAULT_WAIT_TIMEOUT) * 1000000UL;
+        uint32_t elapsed = micros() - waitStartUs;
+        uint32_t left = elapsed < timeout ? timeout - elapsed : 0;
+        return left < WAIT_POLL_INTERVAL ? left : WAIT_POLL_INTERVAL;
+    }
+    if (size == 0)
+    {
+        return UINT32_MAX;
+    }
+    int32_t remaining = (int32_t)(heap[0].dueUs - micros());
+    return remaining > 0 ? (uint32_t)remaining : 0;
+}
+
+/**
+ * @brief Get the worst lateness of a fired event since the last call
+ */
+uint32_t Choreography::takeMaxLateness()
+{
+    uint32_t lateness = maxLatenessUs;
+    maxLatenessUs = 0;
+    return lateness;
+}
+
+/**
+ * @brief Heap order: earliest due time first, then scheduling order
+ *
+ * Due times are compared as a signed difference so the order survives the
+ * micros() wrap-around (every ~71 minutes).
+ */
+bool Choreography::before(const PendingEvent &a, const PendingEvent &b)
+{
+    int32_t diff = (int32_t)(a.dueUs - b.dueUs);
+    if (diff != 0)
+    {
+        return diff < 0;
+    }
+    return (int16_t)(a.seq - b.seq) < 0;
+}
+
+bool Choreography::push(const SceneEvent &event, uint32_t dueUs, bool fromScene)
+{
+    if (size >= CHOREOGRAPHY_CAPACITY)
+    {
+        return false;
+    }
+    PendingEvent &slot = heap[size];
+    slot.dueUs = dueUs;
+    slot.seq = nextSeq++;
+    slot.fromScene = fromScene;
+    slot.event = event;
+    siftUp(size);
+    size++;
+    if (fromScene)
+    {
+        sceneEntries++;
+    }
+    return true;
+}
+
+void Choreography::pop(PendingEvent &out)
+{
+    out = heap[0];
+    size--;
+    if (size > 0)
+    {
+        heap[0] = heap[size];
+        siftDown(0);
+    }
+}
+
+void Choreography::siftUp(uint8_t index)
+{
+    PendingEvent moving = heap[index];
+    while (index > 0)
+    {
+        uint8_t parent = (index - 1) / 2;
+        if (!before(moving, heap[parent]))
+        {
+            break;
+        }
+        heap[index] = heap[parent];
+        index = parent;
+    }
+    heap[index] = moving;
+}
+
+void Choreography::siftDown(uint8_t index)
+{
+    PendingEvent moving = heap[index];
+    while (true)
+    {
+        uint8_t child = 2 * index + 1;
+        if (child >= size)
+        {
+            break;
+        }
+        if (child + 1 < size && before(heap[child + 1], heap[child]))
+        {
+            child++;
+        }
+        if (!before(heap[child], moving))
+        {
+            break;
+        }
+        heap[index] = heap[child];
+        index = child;
+    }
+    heap[index] = moving;
+}
+
+/**
+ * @brief Push scene events up to (and including) the next wait
+ */
+void Choreography::pushSegment()
+{
+    if (scene == NULL)
+    {
+        return;
+    }
+    while (cursor < scene->count)
+    {
+        const SceneEvent &event = scene->events[cursor];
+        if (!push(event, baseUs + (uint32_t)event.atMs * 1000, true))
+        {
+            return; // Full, update() pushes the rest later
+        }
+        cursor++;
+        if (event.type == SCENE_WAIT_TRACK_END)
+        {
+            return; // Next segment is timed from the end of the wait
+        }
+    }
+}
+
+/**
+ * @brief Remove the scene events from the heap, keeping one-off events
+ */
+void Choreography::removeSceneEvents()
+{
+    uint8_t kept = 0;
+    for (uint8_t i = 0; i < size; i++)
+    {
+        if (!heap[i].fromScene)
+        {
+            heap[kept++] = heap[i];
+        }
+    }
+    size = kept;
+    sceneEntries = 0;
+    // Rebuild the heap property bottom-up
+    for (int16_t i = size / 2 - 1; i >= 0; i--)
+    {
+        siftDown(i);
+    }
+}
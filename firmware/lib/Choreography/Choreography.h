@@ -0,0 +1,182 @@
+#ifndef CHOREOGRAPHY_H
+#define CHOREOGRAPHY_H
+
+#include <Arduino.h>
+
+/**
+ * @brief Scene event types
+ */
+enum SceneEventType
+{
+    SCENE_PLAY_SOUND,     // a: folder, b: track (0 = random track of the folder)
+    SCENE_GAZE,           // a: x (0-6), b: y (0-6)
+    SCENE_MODE,           // a: EyeMode
+    SCENE_BLINK,          // Close the eyes and open them again
+    SCENE_BRIGHTNESS,     // a: level (0-15), SCENE_BRIGHTNESS_AUTO to release
+    SCENE_WAIT_TRACK_END, // Hold the timeline until the sound ends, b: timeout (s, 0 = 30s)
+    SCENE_FADE,           // a: perceptual level (0-255), b: duration (x50ms)
+    SCENE_BREATHE,        // a: lowest perceptual level (0-255), b: period (x100ms)
+    SCENE_FLASH,          // b: decay duration (x50ms)
+    SCENE_TEXT,           // a: message index, b: speed (ms per column, 0 = default)
+    SCENE_START,          // a: scene index, starts another scene (e.g. one sent by the skull bus)
+};
+
+// SCENE_BRIGHTNESS level giving the brightness back to ambient light adaptation
+#define SCENE_BRIGHTNESS_AUTO 0xFF
+
+// Max number of pending events (scene and one-off events)
+#define CHOREOGRAPHY_CAPACITY 32
+
+/**
+ * @brief One timestamped event of a scene
+ *
+ * Events after a SCENE_WAIT_TRACK_END are timed from the end of the wait:
+ * an event at 1500ms after a wait at 1000ms fires 500ms after the wait ends.
+ */
+typedef struct
+{
+    uint16_t atMs; // Time from the start of the scene (ms)
+    uint8_t type;  // SceneEventType
+    uint8_t a;
+    uint8_t b;
+} SceneEvent;
+
+/**
+ * @brief A scene: a timeline of events, kept in flash (built-in or asset pack)
+ */
+typedef struct
+{
+    const char *name;
+    const SceneEvent *events;
+    uint8_t count;
+} Scene;
+
+/**
+ * @brief Event handler
+ *
+ * Called for every event when it is due. For SCENE_WAIT_TRACK_END, return
+ * false while the sound is still playing, the handler is then called again
+ * on each update() until it returns true. The return value of the other
+ * events is ignored.
+ */
+typedef bool (*SceneHandler)(const SceneEvent &event);
+
+/**
+ * @brief Choreography class, plays scenes of synchronized sounds and eye moves
+ *
+ * Pending events are kept in a fixed-capacity binary min-heap ordered by due
+ * time (microseconds), so the next event is always at the top: O(1) to check,
+ * O(log n) to schedule or fire, no allocation. Events are pushed segment by
+ * segment (up to the next wait) as the scene progresses.
+ */
+class Choreography
+{
+public:
+    Choreography();
+
+    /**
+     * @brief Set the event handler
+     * Must be called in setup() before starting scenes
+     *
+     * @param handler Function applying the events to the eyes and sounds
+     */
+    void begin(SceneHandler handler);
+
+    /**
+     * @brief Start a scene, replacing the one in progress if any
+     *
+     * @param scene Scene to play, copied: only its name and events must
+     *              outlive its playback
+     */
+    void start(const Scene &scene);
+
+    /**
+     * @brief Stop the scene in progress, one-off events are kept
+     */
+    void stop();
+
+    /**
+     * @brief Schedule a one-off event, outside of any scene
+     *
+     * @param event Event to fire (atMs is ignored)
+     * @param dueUs micros() value when it must fire
+     *
+     * @return true if scheduled, false if the queue is full
+     */
+    bool schedule(const SceneEvent &event, uint32_t dueUs);
+
+    /**
+     * @brief Fire the events that are due (call this in loop())
+     */
+    void update();
+
+    /**
+     * @brief Check if a scene is in progress
+     */
+    bool isRunning();
+
+    /**
+     * @brief Get the scene in progress
+     *
+     * @return The scene, or NULL if none
+     */
+    const Scene *getScene();
+
+    /**
+     * @brief Time until the next event is due
+     *
+     * Use it to wake up in time, e.g. to bound the loop idle time.
+     *
+     * @return Microseconds until the next event, 0 if overdue, the poll
+     *         interval while waiting on a sound, UINT32_MAX if nothing is
+     *         pending
+     */
+    uint32_t timeUntilNext();
+
+    /**
+     * @brief Get the worst lateness of a fired event since the last call
+     *
+     * @return Lateness (us), then reset to 0
+     */
+    uint32_t takeMaxLateness();
+
+private:
+    struct PendingEvent
+    {
+        uint32_t dueUs;
+        uint16_t seq;    // Keeps events due at the same time in order
+        bool fromScene;
+        SceneEvent event;
+    };
+
+    PendingEvent heap[CHOREOGRAPHY_CAPACITY];
+    uint8_t size;
+    uint16_t nextSeq;
+
+    SceneHandler handler;
+
+    Scene current;        // Copy of the scene in progress
+    const Scene *scene;   // &current, or NULL if none
+    uint8_t cursor;       // Next scene event to push
+    uint8_t sceneEntries; // Scene events in the heap
+    uint32_t baseUs;      // micros() at the start of the current segment
+
+    bool waiting;
+    SceneEvent waitEvent;
+    uint32_t waitStartUs;
+
+    uint32_t maxLatenessUs;
+
+    static const uint32_t DEFAULT_WAIT_TIMEOUT = 30;  // s
+    static const uint32_t WAIT_POLL_INTERVAL = 25000; // Track end checks while waiting (us)
+
+    static bool before(const PendingEvent &a, const PendingEvent &b);
+    bool push(const SceneEvent &event, uint32_t dueUs, bool fromScene);
+    void pop(PendingEvent &out);
+    void siftUp(uint8_t index);
+    void siftDown(uint8_t index);
+    void pushSegment();
+    void removeSceneEvents();
+};
+
+#endif // CHOREOGRAPHY_H
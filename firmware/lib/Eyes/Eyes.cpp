@@ -1,13 +1,39 @@
 #include "Eyes.h"
 
+/**
+ * @brief Perceived brightness of each intensity register value
+ *
+ * The MAX7219 duty cycle is (2 * register + 1) / 32. Perceived brightness
+ * follows duty^(1/2.2), scaled to 0-255. Picking the register closest to a
+ * perceptual level gives a gamma corrected curve with only 16 steps.
+ */
+static const uint8_t PERCEIVED_INTENSITY[16] = {
+    53, 87, 110, 128, 143, 157, 169, 181, 191, 201, 211, 219, 228, 236, 244, 251};
+
+/**
+ * @brief Temporal dithering schedules
+ *
+ * DITHER_SCHEDULES[k] has k bits set out of DITHER_FRAMES, spread as evenly
+ * as possible (Bresenham): bit i of the schedule tells if frame i shows the
+ * next pixel. Fractions are rounded to k/DITHER_FRAMES.
+ */
+#define DITHER_FRAMES 8
+static const uint8_t DITHER_SCHEDULES[DITHER_FRAMES] = {
+    0x00, 0x80, 0x88, 0xA4, 0xAA, 0xDA, 0xEE, 0xFE};
+
+/**
+ * @brief Pixels of an open eye, the iris and lids are cut out of it
+ */
+static const uint8_t EYE_SHAPE[8] = {0x3C, 0x7E, 0xFF, 0xFF, 0xFF, 0xFF, 0x7E, 0x3C};
+
 /**
  * @brief Construct a new Eyes object
  *
- * Initializes the MD_MAX72XX object and sets up default values for
- * iris positions and modes.
+ * Sets up default values for iris positions and modes.
+ *
+ * @param display Output backend, e.g. a Max7219Display
  */
-Eyes::Eyes(uint8_t hardwareType, uint8_t dataPin, uint8_t clkPin, uint8_t csPin)
-    : mx((MD_MAX72XX::moduleType_t)hardwareType, dataPin, clkPin, csPin, MAX_DEVICES)
+Eyes::Eyes(EyesDisplay &display) : display(display)
 {
     // Initialize current and target positions to (3, 0) for testing orientation
     currentLeft.x = 3;
@@ -23,6 +49,34 @@ Eyes::Eyes(uint8_t hardwareType, uint8_t dataPin, uint8_t clkPin, uint8_t csPin)
     // Initialize modes
     currentMode = NORMAL;
     targetMode = NORMAL;
+    modeQueueHead = 0;
+    modeQueueCount = 0;
+    modeStats = {0, 0, 0};
+
+    // Actual value is written to the devices in begin()
+    brightness = DEFAULT_BRIGHTNESS;
+    intensity = DEFAULT_BRIGHTNESS;
+    intensityEffect = INTENSITY_STEADY;
+    level = 255;
+    effectFrom = 255;
+    effectTo = 255;
+    effectStart = 0;
+    effectDuration = 0;
+    shutdown = false;
+    canvasSwapPanels = false;
+    canvasMirrorColumns = false;
+
+    smoothLeft.x = 3 << 8;
+    smoothLeft.y = 3 << 8;
+    smoothRight.x = 3 << 8;
+    smoothRight.y = 3 << 8;
+    smoothGaze = false;
+    framePeriodUs = 0;
+    gazeSpeed = 0;
+    lastFrameTimeUs = 0;
+    ditherPhase = 0;
+    smoothFrame = false;
+    frameStats = {0, 0, 0, 0};
 
     // Initialize effect step counter
     step = 0;
@@ -34,6 +88,8 @@ Eyes::Eyes(uint8_t hardwareType, uint8_t dataPin, uint8_t clkPin, uint8_t csPin)
         leftEyeBuffer[i] = 0x00;
         rightEyeBuffer[i] = 0x00;
     }
+    lidMask = 0xFF;
+    shape = EYE_SHAPE;
 }
 
 /**
@@ -43,17 +99,27 @@ Eyes::Eyes(uint8_t hardwareType, uint8_t dataPin, uint8_t clkPin, uint8_t csPin)
 void Eyes::begin()
 {
     // Initialize the display
-    mx.begin();
-    mx.control(MD_MAX72XX::INTENSITY, DEFAULT_BRIGHTNESS);
+    display.begin();
+    brightness = DEFAULT_BRIGHTNESS;
+    intensity = DEFAULT_BRIGHTNESS;
+    display.setIntensity(intensity);
 };
 
 /**
  * @brief Check if an animation is in progress
  *
- * @return true if animating, false if idle
+ * @return true if animating or mode requests are queued, false if idle
  */
 bool Eyes::isAnimating()
 {
+    if (modeQueueCount > 0)
+    {
+        return true;
+    }
+    if (smoothGaze)
+    {
+        return isGliding() || (currentMode != targetMode);
+    }
     return (currentLeft.x != targetLeft.x) ||
            (currentLeft.y != targetLeft.y) ||
            (currentRight.x != targetRight.x) ||
@@ -61,17 +127,241 @@ bool Eyes::isAnimating()
            (currentMode != targetMode);
 }
 
+/**
+ * @brief Set the shape of an open eye
+ *
+ * Applies from the next redraw.
+ *
+ * @param shape 8 column bytes, NULL for the built-in round eye
+ */
+void Eyes::setShape(const uint8_t *shape)
+{
+    this->shape = shape != NULL ? shape : EYE_SHAPE;
+}
+
 /**
  * @brief Set the display brightness
  *
+ * The intensity register is only written when its value actually changes,
+ * so this can be called every loop (e.g. from ambient light adaptation).
+ *
  * @param brightness Brightness level (0-15)
  */
 void Eyes::setBrightness(uint8_t brightness)
 {
-    brightness = constrain(brightness, 0, 15);
-    mx.control(MD_MAX72XX::INTENSITY, brightness);
+    this->brightness = constrain(brightness, 0, 15);
+    stepIntensity();
 };
 
+/**
+ * @brief Fade the intensity to a level
+ *
+ * @param level Target level (0-255)
+ * @param durationMs Fade duration (ms)
+ */
+void Eyes::fadeTo(uint8_t level, unsigned long durationMs)
+{
+    intensityEffect = INTENSITY_FADE;
+    effectFrom = this->level;
+    effectTo = level;
+    effectStart = millis();
+    effectDuration = durationMs;
+    stepIntensity();
+}
+
+/**
+ * @brief Breathe: continuously fade between two levels
+ *
+ * The wave goes down first. The start phase is chosen so that the wave
+ * starts at the current level.
+ *
+ * @param minLevel Lowest level (0-255)
+ * @param maxLevel Highest level (0-255)
+ * @param periodMs Duration of a full cycle (ms)
+ */
+void Eyes::breathe(uint8_t minLevel, uint8_t maxLevel, unsigned long periodMs)
+{
+    if (minLevel >= maxLevel || periodMs < 2)
+    {
+        fadeTo(maxLevel, periodMs / 2);
+        return;
+    }
+
+    uint8_t current = constrain(level, minLevel, maxLevel);
+    unsigned long half = periodMs / 2;
+    unsigned long phase = (unsigned long)(maxLevel - current) * half / (maxLevel - minLevel);
+
+    intensityEffect = INTENSITY_BREATHE;
+    effectFrom = minLevel;
+    effectTo = maxLevel;
+    effectStart = millis() - phase;
+    effectDuration = periodMs;
+    stepIntensity();
+}
+
+/**
+ * @brief Flash: jump to full intensity, then decay back to the current level
+ *
+ * @param durationMs Decay duration (ms)
+ */
+void Eyes::flash(unsigned long durationMs)
+{
+    intensityEffect = INTENSITY_FLASH;
+    effectStart = millis();
+    effectDuration = durationMs;
+    stepIntensity();
+}
+
+/**
+ * @brief Stop the intensity effect, holding the current level
+ */
+void Eyes::stopIntensityEffect()
+{
+    intensityEffect = INTENSITY_STEADY;
+    stepIntensity();
+}
+
+/**
+ * @brief Step the intensity effect
+ *
+ * Effects work on perceptual levels; the register is only touched when the
+ * closest register value changes, i.e. one 2-byte SPI write per visible
+ * step instead of a 16-row bitmap refresh.
+ */
+void Eyes::stepIntensity()
+{
+    unsigned long elapsed = millis() - effectStart;
+    // Absolute perceptual level of the full-scale brightness
+    uint8_t fullScale = PERCEIVED_INTENSITY[brightness];
+    uint8_t perceived;
+
+    switch (intensityEffect)
+    {
+    case INTENSITY_FADE:
+        if (elapsed >= effectDuration)
+        {
+            level = effectTo;
+            intensityEffect = INTENSITY_STEADY;
+        }
+        else
+        {
+            level = effectFrom + ((int32_t)effectTo - effectFrom) * (int32_t)elapsed / (int32_t)effectDuration;
+        }
+        break;
+
+    case INTENSITY_BREATHE:
+    {
+        // Triangle wave, down for the first half period, up for the second
+        unsigned long half = effectDuration / 2;
+        unsigned long phase = elapsed % effectDuration;
+        unsigned long distance = (phase < half) ? phase : effectDuration - phase;
+        level = effectTo - (uint32_t)(effectTo - effectFrom) * min(distance, half) / half;
+        break;
+    }
+
+    default:
+        break;
+    }
+
+    perceived = (uint32_t)level * fullScale / 255;
+
+    if (intensityEffect == INTENSITY_FLASH)
+    {
+        if (elapsed >= effectDuration)
+        {
+            intensityEffect = INTENSITY_STEADY;
+        }
+        else
+        {
+            // Decay from the maximum, absolute, intensity down to the level
+            perceived = 255 - (uint32_t)(255 - perceived) * elapsed / effectDuration;
+        }
+    }
+
+    // Closest register value
+    uint8_t value = 0;
+    for (uint8_t i = 1; i < 16; i++)
+    {
+        if (abs((int)PERCEIVED_INTENSITY[i] - perceived) < abs((int)PERCEIVED_INTENSITY[value] - perceived))
+        {
+            value = i;
+        }
+    }
+
+    if (value != intensity)
+    {
+        intensity = value;
+        display.setIntensity(intensity);
+    }
+}
+
+/**
+ * @brief Glide the irises between pixels
+ *
+ * @param refreshHz Frame rate while gliding (Hz), 0 to disable gliding
+ * @param pixelsPerSecond Iris speed
+ */
+void Eyes::setSmoothGaze(uint16_t refreshHz, uint16_t pixelsPerSecond)
+{
+    if (smoothGaze && refreshHz == 0)
+    {
+        // Back to whole pixels, from the closest one
+        currentLeft.x = (smoothLeft.x + 128) >> 8;
+        currentLeft.y = (smoothLeft.y + 128) >> 8;
+        currentRight.x = (smoothRight.x + 128) >> 8;
+        currentRight.y = (smoothRight.y + 128) >> 8;
+    }
+    else if (!smoothGaze && refreshHz != 0)
+    {
+        smoothLeft.x = currentLeft.x << 8;
+        smoothLeft.y = currentLeft.y << 8;
+        smoothRight.x = currentRight.x << 8;
+        smoothRight.y = currentRight.y << 8;
+    }
+
+    smoothGaze = (refreshHz != 0);
+    framePeriodUs = smoothGaze ? 1000000UL / refreshHz : 0;
+    gazeSpeed = max(pixelsPerSecond, (uint16_t)1);
+}
+
+/**
+ * @brief Time until the next high-refresh frame
+ *
+ * @return Microseconds until the next frame, UINT32_MAX if not gliding
+ */
+uint32_t Eyes::timeUntilNextFrame()
+{
+    if (!smoothGaze || !isGliding())
+    {
+        return UINT32_MAX;
+    }
+    unsigned long elapsed = micros() - lastFrameTimeUs;
+    return elapsed >= framePeriodUs ? 0 : framePeriodUs - elapsed;
+}
+
+/**
+ * @brief Get the rendering statistics since the last call
+ *
+ * @return Statistics, then reset
+ */
+EyesFrameStats Eyes::takeFrameStats()
+{
+    EyesFrameStats stats = frameStats;
+    frameStats = {0, 0, 0, 0};
+    return stats;
+}
+
+/**
+ * @brief Check if a fixed-point position has not reached its target yet
+ */
+bool Eyes::isGliding()
+{
+    return (smoothLeft.x != targetLeft.x << 8) ||
+           (smoothLeft.y != targetLeft.y << 8) ||
+           (smoothRight.x != targetRight.x << 8) ||
+           (smoothRight.y != targetRight.y << 8);
+}
+
 /**
  * @brief Set target position for both irises (synchronized movement)
  *
@@ -132,33 +422,130 @@ void Eyes::immediatePosition(uint8_t xl, uint8_t yl, uint8_t xr, uint8_t yr)
     targetLeft.y = constrain(yl, 0, 6);
     targetRight.x = constrain(xr, 0, 6);
     targetRight.y = constrain(yr, 0, 6);
+    smoothLeft.x = currentLeft.x << 8;
+    smoothLeft.y = currentLeft.y << 8;
+    smoothRight.x = currentRight.x << 8;
+    smoothRight.y = currentRight.y << 8;
+}
+
+/**
+ * @brief Set the target eye mode, now
+ *
+ * Interrupts the transition in progress and drops the queued requests.
+ *
+ * @param mode Target mode (NORMAL, CLOSED, CROSS, SILLY)
+ */
+void Eyes::requestMode(EyeMode mode)
+{
+    flushModeQueue();
+    if (currentMode != targetMode && mode != targetMode)
+    {
+        modeStats.preempted++;
+    }
+    startMode(mode);
 }
 
 /**
- * @brief Set the target eye mode
+ * @brief Queue an eye mode after the transitions in progress and queued
+ *
+ * Starts right away when the eyes are idle.
  *
  * @param mode Target mode (NORMAL, CLOSED, CROSS, SILLY)
  *
- * @return true if the mode change request was accepted
+ * @return false if the queue is full (the request is dropped)
  */
-bool Eyes::requestMode(EyeMode mode)
+bool Eyes::queueMode(EyeMode mode)
 {
-    if (targetMode != currentMode)
+    if (currentMode == targetMode && modeQueueCount == 0)
     {
-        return false; // Reject new mode request if an animation is in progress
+        startMode(mode);
+        return true;
     }
-    targetMode = mode;
-    step = 0; // Reset effect step counter
+    if (modeQueueCount >= EYES_MODE_QUEUE_SIZE)
+    {
+        modeStats.dropped++;
+        return false;
+    }
+    modeQueue[(modeQueueHead + modeQueueCount) % EYES_MODE_QUEUE_SIZE] = mode;
+    modeQueueCount++;
+    modeStats.queued++;
     return true;
 }
 
+/**
+ * @brief Get the mode request counters
+ *
+ * @return Counters since begin()
+ */
+EyesModeStats Eyes::getModeStats()
+{
+    return modeStats;
+}
+
+/**
+ * @brief Start the transition to a mode
+ *
+ * Lid levels go from 0 (open) to 4 (closed): closing step n shows level n,
+ * opening step n shows level 4 - n. Reversing a lid animation swaps closing
+ * and opening and mirrors the step, so the lids turn back from where they
+ * are, on the same step timing.
+ *
+ * @param mode Target mode
+ */
+void Eyes::startMode(EyeMode mode)
+{
+    if (mode == targetMode)
+    {
+        return; // Already there or on the way
+    }
+
+    bool closing = targetMode == CLOSED && currentMode != CLOSED;
+    bool opening = currentMode == CLOSED && targetMode != CLOSED;
+    if (step > 0 && closing)
+    {
+        // Half-closed, open again from this level
+        currentMode = CLOSED;
+        targetMode = mode;
+        step = 4 - step;
+    }
+    else if (step > 0 && opening && mode == CLOSED)
+    {
+        // Half-open, close again from this level
+        currentMode = targetMode;
+        targetMode = CLOSED;
+        step = 4 - step;
+    }
+    else if (step > 0 && opening)
+    {
+        targetMode = mode; // Keep opening, onto another open mode
+    }
+    else
+    {
+        targetMode = mode;
+        step = 0; // Reset effect step counter
+    }
+}
+
+/**
+ * @brief Drop the queued mode requests
+ */
+void Eyes::flushModeQueue()
+{
+    modeStats.dropped += modeQueueCount;
+    modeQueueHead = 0;
+    modeQueueCount = 0;
+}
+
 /**
  * @brief Set the eye mode immediately, no animation
  *
+ * Queued requests are dropped.
+ *
  * @param mode Target mode (NORMAL, CLOSED, CROSS, SILLY)
  */
 void Eyes::immediateMode(EyeMode mode)
 {
+    flushModeQueue();
     currentMode = mode;
     targetMode = mode;
     step = 0; // Reset effect step counter
@@ -167,41 +554,186 @@ void Eyes::immediateMode(EyeMode mode)
 /**
  * @brief Send the internal buffers to the physical displays
  *
- * Transfers the leftEyeBuffer and rightEyeBuffer to the corresponding
- * MAX7219 devices. Device 0 is the right eye, Device 1 is the left eye
- * (due to daisy-chaining order).
+ * Hands the leftEyeBuffer and rightEyeBuffer to the display backend, with
+ * the layers a color backend needs.
+ *
+ * @param eyeShapes false when the buffers hold a canvas instead of eyes
  */
-void Eyes::send()
+void Eyes::send(bool eyeShapes)
 {
-    // Disable display updates while we update all rows
-    mx.control(MD_MAX72XX::UPDATE, MD_MAX72XX::OFF);
+    EyesFrame frame = {
+        .left = leftEyeBuffer,
+        .right = rightEyeBuffer,
+        .shape = eyeShapes ? shape : NULL,
+        .lidMask = lidMask,
+    };
+    frameStats.rowsSent += display.show(frame);
+}
 
-    // Send right eye buffer to device 0
-    for (uint8_t row = 0; row < 8; row++)
+/**
+ * @brief Step the intensity effect and carry on display transfers
+ */
+void Eyes::updateIntensity()
+{
+    if (intensityEffect != INTENSITY_STEADY)
     {
-        mx.setRow(0, row, rightEyeBuffer[row]);
+        stepIntensity();
     }
 
-    // Send left eye buffer to device 1
-    for (uint8_t row = 0; row < 8; row++)
+    display.update();
+}
+
+/**
+ * @brief Update the display
+ *
+ * Runs the animation and only sends the buffers when they were redrawn.
+ * While the eyes are fully closed the MAX7219 are put in SHUTDOWN mode
+ * (display blanked, ~150uA each) instead of pushing all-zero rows; they are
+ * woken up as soon as the opening animation draws its first frame.
+ */
+void Eyes::update()
+{
+    unsigned long start = micros();
+
+    updateIntensity();
+
+    smoothFrame = false;
+    bool redrawn = animate();
+
+    if (currentMode == CLOSED && targetMode == CLOSED)
     {
-        mx.setRow(1, row, leftEyeBuffer[row]);
+        if (!shutdown)
+        {
+            if (redrawn)
+            {
+                send(); // Leave blank rows in the registers for the wake up
+            }
+            display.setShutdown(true);
+            shutdown = true;
+        }
+        return;
     }
 
-    // Re-enable display updates
-    mx.control(MD_MAX72XX::UPDATE, MD_MAX72XX::ON);
+    if (redrawn)
+    {
+        send();
+        if (shutdown)
+        {
+            display.setShutdown(false);
+            shutdown = false;
+        }
+    }
+
+    if (smoothFrame)
+    {
+        frameStats.busyUs += micros() - start;
+    }
 }
 
 /**
- * @brief Update the display (temporary implementation)
+ * @brief Check if the CPU may light sleep
  *
- * For now, just calls send() to refresh the display.
- * Will later handle interpolation and animations.
+ * @return false while the display backend is sending a frame
  */
-void Eyes::update()
+bool Eyes::canSleep()
+{
+    return !display.isBusy();
+}
+
+/**
+ * @brief Check if the displays are in SHUTDOWN mode
+ *
+ * @return true if the displays are shut down
+ */
+bool Eyes::isShutdown()
+{
+    return shutdown;
+}
+
+/**
+ * @brief Count the LEDs currently lit on both displays
+ *
+ * @return Number of lit LEDs (0-128), 0 when shut down
+ */
+uint8_t Eyes::litPixels()
+{
+    if (shutdown)
+    {
+        return 0;
+    }
+
+    uint8_t count = 0;
+    for (uint8_t i = 0; i < 8; i++)
+    {
+        count += __builtin_popcount(leftEyeBuffer[i]);
+        count += __builtin_popcount(rightEyeBuffer[i]);
+    }
+    return count;
+}
+
+/**
+ * @brief Get the current intensity register value
+ *
+ * @return Intensity level (0-15)
+ */
+uint8_t Eyes::getBrightness()
 {
-    animate();
-    send();
+    return intensity;
+}
+
+/**
+ * @brief Get the intensity effect in progress
+ */
+IntensityEffect Eyes::getIntensityEffect()
+{
+    return intensityEffect;
+}
+
+/**
+ * @brief Set how the canvas maps onto the two displays
+ *
+ * @param swapPanels Columns 0-7 go to the right eye instead
+ * @param mirrorColumns Reverse the column order within each eye
+ */
+void Eyes::setCanvasOrientation(bool swapPanels, bool mirrorColumns)
+{
+    canvasSwapPanels = swapPanels;
+    canvasMirrorColumns = mirrorColumns;
+}
+
+/**
+ * @brief Draw a canvas spanning both eyes
+ *
+ * The displays are tilted: a canvas column is a buffer row, the same as the
+ * iris x coordinate, and the top of the canvas is the high bit, the same as
+ * the iris y coordinate.
+ *
+ * @param columns EYES_CANVAS_WIDTH column bitmaps
+ */
+void Eyes::drawCanvas(const uint8_t *columns)
+{
+    for (uint8_t c = 0; c < EYES_CANVAS_WIDTH; c++)
+    {
+        bool firstHalf = (c < 8) != canvasSwapPanels;
+        uint8_t *buffer = firstHalf ? leftEyeBuffer : rightEyeBuffer;
+        uint8_t row = canvasMirrorColumns ? 7 - (c & 7) : (c & 7);
+
+        // Canvas bit 0 (top) goes to bit 7
+        uint8_t bits = columns[c];
+        uint8_t reversed = 0;
+        for (uint8_t b = 0; b < 8; b++)
+        {
+            reversed = (reversed << 1) | ((bits >> b) & 1);
+        }
+        buffer[row] = reversed;
+    }
+
+    send(false);
+    if (shutdown)
+    {
+        display.setShutdown(false);
+        shutdown = false;
+    }
 }
 
 /**
@@ -223,22 +755,10 @@ void Eyes::makeEyes()
     // ..XXXXX..
     for (uint8_t i = 0; i < 8; i++)
     {
-        if (i == 0 || i == 7)
-        {
-            leftEyeBuffer[i] = 0x3C;  // 00111100
-            rightEyeBuffer[i] = 0x3C; // 00111100
-        }
-        else if (i == 1 || i == 6)
-        {
-            leftEyeBuffer[i] = 0x7E;  // 01111110
-            rightEyeBuffer[i] = 0x7E; // 01111110
-        }
-        else
-        {
-            leftEyeBuffer[i] = 0xFF;
-            rightEyeBuffer[i] = 0xFF;
-        }
+        leftEyeBuffer[i] = shape[i];
+        rightEyeBuffer[i] = shape[i];
     }
+    lidMask = 0xFF;
 
     // Create 2x2 iris (OFF pixels) for left eye
     // The iris occupies rows [leftY, leftY+1] and columns [leftX, leftX+1]
@@ -271,18 +791,38 @@ void Eyes::makeEyes()
  */
 bool Eyes::animate()
 {
+    bool redrawn;
+
     // Closed handles both closing and opening
     if (currentMode == CLOSED || targetMode == CLOSED)
     {
-        return effectClosed();
+        redrawn = effectClosed();
+    }
+    else
+    {
+        // The open modes share the same drawing, nothing to animate
+        currentMode = targetMode;
+        redrawn = effectNormal();
     }
 
-    // Default
-    return effectNormal();
+    // Chain the next queued transition without waiting for another update()
+    if (currentMode == targetMode && modeQueueCount > 0)
+    {
+        EyeMode next = modeQueue[modeQueueHead];
+        modeQueueHead = (modeQueueHead + 1) % EYES_MODE_QUEUE_SIZE;
+        modeQueueCount--;
+        startMode(next);
+    }
+    return redrawn;
 }
 
 bool Eyes::effectNormal()
 {
+    if (smoothGaze)
+    {
+        return effectSmooth();
+    }
+
     unsigned long now = millis();
 
     if (now - lastAnimationStepTimeNormal < ANIMATION_NORMAL_DELAY)
@@ -317,6 +857,83 @@ bool Eyes::effectNormal()
     return true;
 }
 
+/**
+ * @brief Move a fixed-point coordinate toward its target
+ */
+static uint16_t glide(uint16_t position, uint8_t target, uint16_t distance)
+{
+    uint16_t goal = target << 8;
+    if (position < goal)
+    {
+        return (goal - position > distance) ? position + distance : goal;
+    }
+    return (position - goal > distance) ? position - distance : goal;
+}
+
+/**
+ * @brief Pixel shown in a frame for a fixed-point coordinate
+ *
+ * The iris is shown on the next pixel in a share of the frames equal to
+ * the fractional part of the coordinate.
+ */
+static uint8_t dither(uint16_t position, uint8_t phase)
+{
+    uint8_t pixel = position >> 8;
+    uint8_t share = ((position & 0xFF) * DITHER_FRAMES + 128) >> 8;
+    if (share >= DITHER_FRAMES)
+    {
+        return pixel + 1;
+    }
+    return pixel + ((DITHER_SCHEDULES[share] >> phase) & 1);
+}
+
+/**
+ * @brief Gliding variant of the normal effect
+ *
+ * While gliding, a frame is rendered every framePeriodUs: the fixed-point
+ * positions advance by the distance covered since the previous frame and the
+ * irises are drawn on the pixels picked by the dithering schedules. At rest,
+ * frames come at the normal animation pace.
+ */
+bool Eyes::effectSmooth()
+{
+    unsigned long now = micros();
+    bool gliding = isGliding();
+    unsigned long period = gliding ? framePeriodUs : ANIMATION_NORMAL_DELAY * 1000UL;
+    unsigned long elapsed = now - lastFrameTimeUs;
+
+    if (elapsed < period)
+    {
+        return false; // Not enough time has passed
+    }
+    lastFrameTimeUs = now;
+
+    if (gliding)
+    {
+        // Do not jump after a stall (e.g. first frame of a move)
+        elapsed = min(elapsed, 2 * framePeriodUs);
+        uint16_t distance = max((uint32_t)(elapsed * gazeSpeed * 256 / 1000000UL), (uint32_t)1);
+
+        smoothLeft.x = glide(smoothLeft.x, targetLeft.x, distance);
+        smoothLeft.y = glide(smoothLeft.y, targetLeft.y, distance);
+        smoothRight.x = glide(smoothRight.x, targetRight.x, distance);
+        smoothRight.y = glide(smoothRight.y, targetRight.y, distance);
+
+        ditherPhase = (ditherPhase + 1) % DITHER_FRAMES;
+        smoothFrame = true;
+        frameStats.frames++;
+        frameStats.activeUs += elapsed;
+    }
+
+    currentLeft.x = dither(smoothLeft.x, ditherPhase);
+    currentLeft.y = dither(smoothLeft.y, ditherPhase);
+    currentRight.x = dither(smoothRight.x, ditherPhase);
+    currentRight.y = dither(smoothRight.y, ditherPhase);
+
+    makeEyes();
+    return true;
+}
+
 /**
  * @brief Closed eyes effect
  *
@@ -375,6 +992,7 @@ bool Eyes::effectClosed()
             // Gradually turn off columns from top and bottom towards center
             // Because displays are tilted, so the algorithm needs to create "curtains"
             uint8_t mask = (0xFF >> (step << 1)) << step;
+            lidMask = mask;
             for (uint8_t i = 0; i < 8; i++)
             {
                 leftEyeBuffer[i] &= mask;
@@ -388,6 +1006,7 @@ bool Eyes::effectClosed()
             // Because displays are tilted, so the algorithm needs to create "curtains"
             uint8_t invstep = 4 - step;
             uint8_t mask = (0xFF >> (invstep << 1)) << invstep;
+            lidMask = mask;
             for (uint8_t i = 0; i < 8; i++)
             {
                 leftEyeBuffer[i] &= mask;
@@ -397,6 +1016,7 @@ bool Eyes::effectClosed()
         else if (targetMode == CLOSED && currentMode == CLOSED)
         {
             // Fully closed
+            lidMask = 0x00;
             for (uint8_t i = 0; i < 8; i++)
             {
                 leftEyeBuffer[i] = 0x00;
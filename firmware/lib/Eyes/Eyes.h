@@ -2,7 +2,13 @@
 #define EYES_H
 
 #include <Arduino.h>
-#include <MD_MAX72xx.h>
+#include "EyesDisplay.h"
+
+// Width of the canvas spanning both eyes (columns)
+#define EYES_CANVAS_WIDTH 16
+
+// Max number of mode requests waiting behind the transition in progress
+#define EYES_MODE_QUEUE_SIZE 4
 
 /**
  * @brief Eye animation modes
@@ -15,12 +21,45 @@ enum EyeMode
     SILLY   // Silly eye animation
 };
 
+/**
+ * @brief Intensity register effects
+ */
+enum IntensityEffect
+{
+    INTENSITY_STEADY,  // No effect, level is constant
+    INTENSITY_FADE,    // Linear (perceptual) ramp to a target level
+    INTENSITY_BREATHE, // Continuous triangle wave between two levels
+    INTENSITY_FLASH    // Full intensity, then decay back to the level
+};
+
+/**
+ * @brief Rendering statistics of the high-refresh (gliding) frames
+ */
+typedef struct
+{
+    uint32_t frames;   // High-refresh frames rendered
+    uint32_t activeUs; // Time spent gliding, i.e. at the high refresh rate
+    uint32_t busyUs;   // CPU time spent rendering and sending those frames
+    uint32_t rowsSent; // Display rows transferred, all frames included
+} EyesFrameStats;
+
+/**
+ * @brief Mode request counters, since begin()
+ */
+typedef struct
+{
+    uint32_t queued;    // Requests queued behind a transition
+    uint32_t preempted; // Transitions interrupted by a new request
+    uint32_t dropped;   // Queued requests lost: queue full, or flushed by requestMode()
+} EyesModeStats;
+
 /**
  * @brief Eyes class for controlling googly eyes on two 8x8 LED matrices
  *
  * This class abstracts the complexity of displaying animated eyes on two
- * daisy-chained MAX7219-driven 8x8 LED matrices. The eyes are represented
- * as all LEDs on except for a 2x2 square (the iris) that is off.
+ * 8x8 LED matrices, daisy-chained MAX7219 modules or WS2812 panels, through
+ * an EyesDisplay backend. The eyes are represented as all LEDs on except for
+ * a 2x2 square (the iris) that is off.
  */
 class Eyes
 {
@@ -28,12 +67,9 @@ public:
     /**
      * @brief Construct a new Eyes object
      *
-     * @param hardwareType MD_MAX72XX hardware type (e.g., MD_MAX72XX::FC16_HW)
-     * @param dataPin MOSI/Data pin for SPI communication
-     * @param clkPin Clock pin for SPI communication
-     * @param csPin Chip Select pin
+     * @param display Output backend, e.g. a Max7219Display
      */
-    Eyes(uint8_t hardwareType, uint8_t dataPin, uint8_t clkPin, uint8_t csPin);
+    Eyes(EyesDisplay &display);
 
     /**
      * @brief Initialize the Eyes display
@@ -41,13 +77,89 @@ public:
      */
     void begin();
 
+    /**
+     * @brief Set the shape of an open eye
+     *
+     * The iris and lids are cut out of it. Same layout as the display
+     * buffers: one byte per column.
+     *
+     * @param shape 8 column bytes, must outlive the object (e.g. an asset
+     *              pack), NULL for the built-in round eye
+     */
+    void setShape(const uint8_t *shape);
+
     /**
      * @brief Set the display brightness
      *
+     * This is the full-scale brightness that intensity effects are relative to.
+     * Only issues an SPI write when the register value actually changes.
+     *
      * @param brightness Brightness level (0-15)
      */
     void setBrightness(uint8_t brightness);
 
+    /**
+     * @brief Fade the intensity to a level
+     *
+     * Levels are perceptual (gamma corrected) and relative to the brightness
+     * set with setBrightness(): 255 is that brightness, 128 looks half as bright.
+     *
+     * @param level Target level (0-255)
+     * @param durationMs Fade duration (ms)
+     */
+    void fadeTo(uint8_t level, unsigned long durationMs);
+
+    /**
+     * @brief Breathe: continuously fade between two levels
+     *
+     * Starts from the current level, without a jump.
+     *
+     * @param minLevel Lowest level (0-255)
+     * @param maxLevel Highest level (0-255)
+     * @param periodMs Duration of a full cycle (ms)
+     */
+    void breathe(uint8_t minLevel, uint8_t maxLevel, unsigned long periodMs);
+
+    /**
+     * @brief Flash: jump to full intensity, then decay back to the current level
+     *
+     * @param durationMs Decay duration (ms)
+     */
+    void flash(unsigned long durationMs);
+
+    /**
+     * @brief Stop the intensity effect, holding the current level
+     */
+    void stopIntensityEffect();
+
+    /**
+     * @brief Glide the irises between pixels
+     *
+     * Iris positions become fixed-point and move at a constant speed. While
+     * they are between two pixels, the frames are refreshed at a high rate and
+     * alternate between the two neighbouring pixels in the right ratio
+     * (temporal dithering), so the iris appears to glide. Call update() at
+     * least as often as timeUntilNextFrame() asks for.
+     *
+     * @param refreshHz Frame rate while gliding (Hz), 0 to disable gliding
+     * @param pixelsPerSecond Iris speed
+     */
+    void setSmoothGaze(uint16_t refreshHz, uint16_t pixelsPerSecond);
+
+    /**
+     * @brief Time until the next high-refresh frame
+     *
+     * @return Microseconds until the next frame, UINT32_MAX if not gliding
+     */
+    uint32_t timeUntilNextFrame();
+
+    /**
+     * @brief Get the rendering statistics since the last call
+     *
+     * @return Statistics, then reset
+     */
+    EyesFrameStats takeFrameStats();
+
     /**
      * @brief Set target position for both irises (synchronized movement)
      *
@@ -89,17 +201,40 @@ public:
     void immediatePosition(uint8_t xl, uint8_t yl, uint8_t xr, uint8_t yr);
 
     /**
-     * @brief Set the target eye mode
+     * @brief Set the target eye mode, now
+     *
+     * Interrupts the transition in progress: half-closed lids reverse from
+     * their current level instead of finishing the blink first. Queued
+     * requests are dropped.
+     *
+     * @param mode Target mode (NORMAL, CLOSED, CROSS, SILLY)
+     */
+    void requestMode(EyeMode mode);
+
+    /**
+     * @brief Queue an eye mode after the transitions in progress and queued
+     *
+     * Each queued transition starts in the update() that ends the previous
+     * one, e.g. requestMode(CLOSED) then queueMode(NORMAL) blinks.
      *
      * @param mode Target mode (NORMAL, CLOSED, CROSS, SILLY)
      *
-     * @return true if the mode change request was accepted
+     * @return false if the queue is full (the request is dropped)
      */
-    bool requestMode(EyeMode mode);
+    bool queueMode(EyeMode mode);
+
+    /**
+     * @brief Get the mode request counters
+     *
+     * @return Counters since begin()
+     */
+    EyesModeStats getModeStats();
 
     /**
      * @brief Set the eye mode immediately, no animation
      *
+     * Queued requests are dropped.
+     *
      * @param mode Target mode (NORMAL, CLOSED, CROSS, SILLY)
      */
     void immediateMode(EyeMode mode);
@@ -108,20 +243,93 @@ public:
      * @brief Update the display (call this in loop())
      *
      * Handles interpolation between current and target positions/modes,
-     * updates the internal display buffer, and sends data to the matrices.
+     * updates the internal display buffer, and sends data to the matrices
+     * when it changed. Puts the matrices in SHUTDOWN mode while fully closed.
+     * Includes updateIntensity().
      */
     void update();
 
+    /**
+     * @brief Step the intensity effect and carry on display transfers
+     *
+     * Leaves the frame alone: call this instead of update() while something
+     * else owns the displays (e.g. scrolling text), so that a flash or a
+     * breath goes on under it.
+     */
+    void updateIntensity();
+
     /**
      * @brief Check if an animation is in progress
      *
-     * @return true if animating, false if idle
+     * @return true if animating or mode requests are queued, false if idle
      */
     bool isAnimating();
 
+    /**
+     * @brief Check if the CPU may light sleep
+     *
+     * @return false while the display backend is sending a frame
+     */
+    bool canSleep();
+
+    /**
+     * @brief Check if the displays are in SHUTDOWN mode
+     *
+     * The displays are shut down automatically while the eyes are fully closed.
+     *
+     * @return true if the displays are shut down
+     */
+    bool isShutdown();
+
+    /**
+     * @brief Count the LEDs currently lit on both displays
+     *
+     * @return Number of lit LEDs (0-128), 0 when shut down
+     */
+    uint8_t litPixels();
+
+    /**
+     * @brief Get the current intensity register value
+     *
+     * Includes the effect of fades, breathing and flashes.
+     *
+     * @return Intensity level (0-15)
+     */
+    uint8_t getBrightness();
+
+    /**
+     * @brief Get the intensity effect in progress
+     *
+     * @return INTENSITY_STEADY once a fade or flash is over
+     */
+    IntensityEffect getIntensityEffect();
+
+    /**
+     * @brief Set how the canvas maps onto the two displays
+     *
+     * By default canvas columns 0-7 are the left eye and 8-15 the right eye,
+     * in the same order as the iris x coordinate.
+     *
+     * @param swapPanels Columns 0-7 go to the right eye instead
+     * @param mirrorColumns Reverse the column order within each eye
+     */
+    void setCanvasOrientation(bool swapPanels, bool mirrorColumns);
+
+    /**
+     * @brief Draw a canvas spanning both eyes (e.g. scrolling text)
+     *
+     * Column 0 is the leftmost one, bit 0 the top row. Only the rows that
+     * changed since the last transfer are sent, and the displays are woken
+     * up if they were shut down. Do not call update() while the canvas must
+     * stay visible: it takes the displays back on its next redraw.
+     *
+     * @param columns EYES_CANVAS_WIDTH column bitmaps
+     */
+    void drawCanvas(const uint8_t *columns);
+
 private:
-    // MD_MAX72XX object for controlling the displays
-    MD_MAX72XX mx;
+    // Output backend
+    EyesDisplay &display;
 
     // Current and target iris positions (0-6 range due to 2x2 iris size)
     struct IrisPosition
@@ -135,14 +343,64 @@ private:
     IrisPosition currentRight;
     IrisPosition targetRight;
 
+    // Fixed-point (Q8) iris positions while gliding, currentLeft and
+    // currentRight then hold the pixel shown in the current frame
+    struct SmoothPosition
+    {
+        uint16_t x;
+        uint16_t y;
+    };
+
+    SmoothPosition smoothLeft;
+    SmoothPosition smoothRight;
+    bool smoothGaze;
+    unsigned long framePeriodUs;
+    uint16_t gazeSpeed;            // pixels per second
+    unsigned long lastFrameTimeUs;
+    uint8_t ditherPhase;
+    bool smoothFrame;              // animate() rendered a high-refresh frame
+    EyesFrameStats frameStats;
+
     // Current and target modes
     EyeMode currentMode;
     EyeMode targetMode;
 
+    // Mode requests waiting for the transition in progress (ring buffer)
+    EyeMode modeQueue[EYES_MODE_QUEUE_SIZE];
+    uint8_t modeQueueHead;
+    uint8_t modeQueueCount;
+    EyesModeStats modeStats;
+
     // Internal display buffers for each eye (8 bytes per eye)
     uint8_t leftEyeBuffer[8];
     uint8_t rightEyeBuffer[8];
 
+    // Bits not covered by the lids in the buffers, same for every row
+    uint8_t lidMask;
+
+    // Pixels of an open eye
+    const uint8_t *shape;
+
+    // Canvas orientation, see setCanvasOrientation()
+    bool canvasSwapPanels;
+    bool canvasMirrorColumns;
+
+    // Full-scale brightness set with setBrightness() (0-15)
+    uint8_t brightness;
+    // Value currently programmed in the intensity register (0-15)
+    uint8_t intensity;
+
+    // Intensity effect state, levels are perceptual (0-255 of brightness)
+    IntensityEffect intensityEffect;
+    uint8_t level;
+    uint8_t effectFrom;
+    uint8_t effectTo;
+    unsigned long effectStart;
+    unsigned long effectDuration;
+
+    // True while the MAX7219 are in SHUTDOWN mode
+    bool shutdown;
+
     // Effect step counter for stateful animations
     int step;
     // Store the last time an animation step was done
@@ -151,8 +409,6 @@ private:
     unsigned long lastAnimationStepTimeCross;
     unsigned long lastAnimationStepTimeSilly;
 
-    // Default number of devices
-    static const uint8_t MAX_DEVICES = 2;
     static const uint8_t DEFAULT_BRIGHTNESS = 4;
 
     static const unsigned long ANIMATION_NORMAL_DELAY = 50; // ms between animation steps of normal effect
@@ -168,13 +424,36 @@ private:
      */
     void makeEyes();
 
+    /**
+     * @brief Start the transition to a mode
+     *
+     * Reverses a lid animation in progress from its current level.
+     *
+     * @param mode Target mode
+     */
+    void startMode(EyeMode mode);
+
+    /**
+     * @brief Drop the queued mode requests
+     */
+    void flushModeQueue();
+
+    /**
+     * @brief Step the intensity effect
+     *
+     * Computes the perceptual level for the current time and writes the
+     * intensity register if, and only if, its value changes.
+     */
+    void stepIntensity();
+
     /**
      * @brief Send the internal buffers to the physical displays
      *
-     * Transfers the leftEyeBuffer and rightEyeBuffer to the
-     * corresponding MAX7219 devices.
+     * Hands the leftEyeBuffer and rightEyeBuffer to the display backend.
+     *
+     * @param eyeShapes false when the buffers hold a canvas instead of eyes
      */
-    void send();
+    void send(bool eyeShapes = true);
 
     /**
      * @brief Normal eyes effect
@@ -185,6 +464,21 @@ private:
      */
     bool effectNormal();
 
+    /**
+     * @brief Gliding variant of the normal effect
+     *
+     * Moves the fixed-point positions and picks the dithered pixels of the
+     * frame.
+     *
+     * @return true if a frame was rendered
+     */
+    bool effectSmooth();
+
+    /**
+     * @brief Check if a fixed-point position has not reached its target yet
+     */
+    bool isGliding();
+
     /**
      * @brief Closed eyes effect
      *
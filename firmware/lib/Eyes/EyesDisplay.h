@@ -0,0 +1,73 @@
+#ifndef EYES_DISPLAY_H
+#define EYES_DISPLAY_H
+
+#include <stdint.h>
+
+/**
+ * @brief One frame of both eyes, as drawn by the Eyes class
+ *
+ * Rows are indexed by the horizontal coordinate (the displays are tilted),
+ * bit 7 is the top. Besides the lit pixels, a frame tells which pixels belong
+ * to the eye and which ones the lids cover, so that color backends can paint
+ * each layer with its own color.
+ */
+typedef struct
+{
+    const uint8_t *left;  // Lit pixels of the left eye, 8 rows
+    const uint8_t *right; // Lit pixels of the right eye, 8 rows
+    const uint8_t *shape; // Pixels of the eye (sclera and iris), 8 rows, NULL for a canvas
+    uint8_t lidMask;      // Bits not covered by the lids, same for every row
+} EyesFrame;
+
+/**
+ * @brief Output backend of the Eyes class
+ *
+ * The Eyes class draws frames, the backend turns them into light. The
+ * intensity is the MAX7219 intensity register scale: backends without such
+ * register reproduce its duty cycle, (2 * intensity + 1) / 32.
+ */
+class EyesDisplay
+{
+public:
+    virtual ~EyesDisplay() {}
+
+    /**
+     * @brief Initialize the hardware, displays are cleared
+     */
+    virtual void begin() = 0;
+
+    /**
+     * @brief Set the intensity (0-15)
+     */
+    virtual void setIntensity(uint8_t intensity) = 0;
+
+    /**
+     * @brief Blank the displays to save power, or wake them up
+     *
+     * The last frame shows again when woken up.
+     */
+    virtual void setShutdown(bool shutdown) = 0;
+
+    /**
+     * @brief Show a frame
+     *
+     * @return Number of display rows transferred (for statistics)
+     */
+    virtual uint8_t show(const EyesFrame &frame) = 0;
+
+    /**
+     * @brief Carry on transfers that could not be done right away
+     *
+     * Called on every Eyes::update().
+     */
+    virtual void update() {}
+
+    /**
+     * @brief Check if a transfer is in progress
+     *
+     * The CPU must not light sleep until it is over.
+     */
+    virtual bool isBusy() { return false; }
+};
+
+#endif // EYES_DISPLAY_H
@@ -0,0 +1,94 @@
+#include "Max7219Display.h"
+
+/**
+ * @brief Construct a new Max7219Display object, bit-banged SPI
+ */
+Max7219Display::Max7219Display(uint8_t hardwareType, uint8_t dataPin, uint8_t clkPin, uint8_t csPin)
+    : mx((MD_MAX72XX::moduleType_t)hardwareType, dataPin, clkPin, csPin, MAX_DEVICES)
+{
+    init();
+}
+
+/**
+ * @brief Construct a new Max7219Display object using the hardware SPI
+ */
+Max7219Display::Max7219Display(uint8_t hardwareType, uint8_t csPin)
+    : mx((MD_MAX72XX::moduleType_t)hardwareType, csPin, MAX_DEVICES)
+{
+    init();
+}
+
+void Max7219Display::init()
+{
+    for (uint8_t i = 0; i < 8; i++)
+    {
+        // mx.begin() clears the displays
+        sentLeftEye[i] = 0x00;
+        sentRightEye[i] = 0x00;
+    }
+}
+
+/**
+ * @brief Initialize the displays
+ */
+void Max7219Display::begin()
+{
+    mx.begin();
+}
+
+/**
+ * @brief Write the intensity register of both devices
+ */
+void Max7219Display::setIntensity(uint8_t intensity)
+{
+    mx.control(MD_MAX72XX::INTENSITY, intensity);
+}
+
+/**
+ * @brief Enter or leave SHUTDOWN mode (display blanked, ~150uA each)
+ *
+ * The registers keep their content while shut down.
+ */
+void Max7219Display::setShutdown(bool shutdown)
+{
+    mx.control(MD_MAX72XX::SHUTDOWN, shutdown ? MD_MAX72XX::ON : MD_MAX72XX::OFF);
+}
+
+/**
+ * @brief Send a frame
+ *
+ * Rows are compared with what was last sent and only the changed ones are
+ * flushed: an iris step touches 2 to 4 rows, a text scroll step only the
+ * columns that actually changed.
+ *
+ * @return Number of rows transferred
+ */
+uint8_t Max7219Display::show(const EyesFrame &frame)
+{
+    uint8_t rows = 0;
+
+    // Disable display updates while we update all rows
+    mx.control(MD_MAX72XX::UPDATE, MD_MAX72XX::OFF);
+
+    for (uint8_t row = 0; row < 8; row++)
+    {
+        // Right eye is device 0
+        if (frame.right[row] != sentRightEye[row])
+        {
+            mx.setRow(0, row, frame.right[row]);
+            sentRightEye[row] = frame.right[row];
+            rows++;
+        }
+        // Left eye is device 1
+        if (frame.left[row] != sentLeftEye[row])
+        {
+            mx.setRow(1, row, frame.left[row]);
+            sentLeftEye[row] = frame.left[row];
+            rows++;
+        }
+    }
+
+    // Re-enable display updates, only the changed rows are flushed
+    mx.control(MD_MAX72XX::UPDATE, MD_MAX72XX::ON);
+    return rows;
+}
@@ -0,0 +1,55 @@
+#ifndef MAX7219_DISPLAY_H
+#define MAX7219_DISPLAY_H
+
+#include <Arduino.h>
+#include <MD_MAX72xx.h>
+#include "EyesDisplay.h"
+
+/**
+ * @brief Eyes backend for two daisy-chained MAX7219 8x8 LED matrices
+ *
+ * Device 0 is the right eye, device 1 the left eye (daisy-chaining order).
+ * Only the rows that changed since the last frame are transferred.
+ */
+class Max7219Display : public EyesDisplay
+{
+public:
+    /**
+     * @brief Construct a new Max7219Display object, bit-banged SPI
+     *
+     * @param hardwareType MD_MAX72XX hardware type (e.g., MD_MAX72XX::FC16_HW)
+     * @param dataPin MOSI/Data pin for SPI communication
+     * @param clkPin Clock pin for SPI communication
+     * @param csPin Chip Select pin
+     */
+    Max7219Display(uint8_t hardwareType, uint8_t dataPin, uint8_t clkPin, uint8_t csPin);
+
+    /**
+     * @brief Construct a new Max7219Display object using the hardware SPI
+     *
+     * Uses the default SPI bus pins (VSPI on ESP32: CLK 18, MOSI 23). Much
+     * faster than bit-banging, needed for high refresh rates.
+     *
+     * @param hardwareType MD_MAX72XX hardware type (e.g., MD_MAX72XX::FC16_HW)
+     * @param csPin Chip Select pin
+     */
+    Max7219Display(uint8_t hardwareType, uint8_t csPin);
+
+    void begin() override;
+    void setIntensity(uint8_t intensity) override;
+    void setShutdown(bool shutdown) override;
+    uint8_t show(const EyesFrame &frame) override;
+
+private:
+    MD_MAX72XX mx;
+
+    // Rows as last sent to the displays
+    uint8_t sentLeftEye[8];
+    uint8_t sentRightEye[8];
+
+    static const uint8_t MAX_DEVICES = 2;
+
+    void init();
+};
+
+#endif // MAX7219_DISPLAY_H
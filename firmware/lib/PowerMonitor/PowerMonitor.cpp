@@ -0,0 +1,126 @@
+#include "PowerMonitor.h"
+
+/**
+ * @brief Construct a new PowerMonitor object
+ *
+ * @param model Current draw of each component
+ */
+PowerMonitor::PowerMonitor(const PowerModel &model)
+{
+    this->model = model;
+    reset();
+}
+
+/**
+ * @brief Start a new accounting period
+ */
+void PowerMonitor::reset()
+{
+    periodStart = millis();
+    totalTime = 0;
+    sleepTime = 0;
+    displayShutdownTime = 0;
+    audioPlayingTime = 0;
+    cpuCharge = 0;
+    displayCharge = 0;
+    audioCharge = 0;
+    litPixelTime = 0;
+}
+
+/**
+ * @brief Account for one loop iteration
+ *
+ * MAX7219 LED current: each digit (row) is scanned 1/8 of the time, and
+ * within its slot the intensity register gives a (2 * level + 1) / 32 duty,
+ * so a lit LED draws peak * (2 * level + 1) / 256 on average.
+ */
+void PowerMonitor::account(uint32_t elapsedUs, uint32_t sleptUs, const PowerState &state)
+{
+    sleptUs = min(sleptUs, elapsedUs);
+    uint32_t activeUs = elapsedUs - sleptUs;
+
+    totalTime += elapsedUs;
+    sleepTime += sleptUs;
+    cpuCharge += (uint64_t)model.cpuActive * activeUs + (uint64_t)model.cpuLightSleep * sleptUs;
+
+    if (state.displayShutdown)
+    {
+        displayShutdownTime += elapsedUs;
+        displayCharge += (uint64_t)model.displayShutdown * model.displayDevices * elapsedUs;
+    }
+    else
+    {
+        uint32_t ledCurrent = (uint64_t)model.displaySegmentPeak * (2 * state.brightness + 1) * state.litPixels / 256;
+        displayCharge += ((uint64_t)model.displayQuiescent * model.displayDevices + ledCurrent) * elapsedUs;
+        litPixelTime += (uint64_t)state.litPixels * elapsedUs;
+    }
+
+    if (state.audioPlaying)
+    {
+        audioPlayingTime += elapsedUs;
+        audioCharge += (uint64_t)model.audioPlaying * elapsedUs;
+    }
+    else
+    {
+        audioCharge += (uint64_t)model.audioIdle * elapsedUs;
+    }
+}
+
+/**
+ * @brief Print a report and start a new period when the interval elapsed
+ *
+ * @return true if a report was printed
+ */
+bool PowerMonitor::update(Print &out, unsigned long intervalMs)
+{
+    if (millis() - periodStart < intervalMs)
+    {
+        return false;
+    }
+    report(out);
+    reset();
+    return true;
+}
+
+/**
+ * @brief Print the report for the current period
+ *
+ * Average currents are charge / time; energy per hour of operation is the
+ * average power (current x supply voltage) over one hour.
+ */
+void PowerMonitor::report(Print &out)
+{
+    if (totalTime == 0)
+    {
+        return;
+    }
+
+    uint32_t cpuUa = cpuCharge / totalTime;
+    uint32_t displayUa = displayCharge / totalTime;
+    uint32_t audioUa = audioCharge / totalTime;
+    uint32_t totalUa = cpuUa + displayUa + audioUa;
+    // uA x mV = nW, / 1000 = uW = uWh per hour of operation
+    uint32_t microWattHours = (uint64_t)totalUa * model.supplyMillivolts / 1000;
+    uint64_t displayOnTime = totalTime - displayShutdownTime;
+    uint32_t avgLitPixels = displayOnTime ? litPixelTime / displayOnTime : 0;
+
+    out.printf("[power] period %lu s\n", (unsigned long)(totalTime / 1000000));
+    out.printf("[power] duty: cpu asleep %lu%%, display shutdown %lu%%, audio playing %lu%%, avg lit LEDs %lu\n",
+               (unsigned long)percent(sleepTime), (unsigned long)percent(displayShutdownTime),
+               (unsigned long)percent(audioPlayingTime), (unsigned long)avgLitPixels);
+    out.printf("[power] avg current: cpu %lu.%lu mA, display %lu.%lu mA, audio %lu.%lu mA, total %lu.%lu mA\n",
+               (unsigned long)(cpuUa / 1000), (unsigned long)(cpuUa % 1000 / 100),
+               (unsigned long)(displayUa / 1000), (unsigned long)(displayUa % 1000 / 100),
+               (unsigned long)(audioUa / 1000), (unsigned long)(audioUa % 1000 / 100),
+               (unsigned long)(totalUa / 1000), (unsigned long)(totalUa % 1000 / 100));
+    out.printf("[power] estimated per hour: %lu mAh, %lu mWh\n",
+               (unsigned long)(totalUa / 1000), (unsigned long)(microWattHours / 1000));
+}
+
+/**
+ * @brief Percentage of the period
+ */
+uint32_t PowerMonitor::percent(uint64_t part)
+{
+    return (part * 100 + totalTime / 2) / totalTime;
+}
@@ -0,0 +1,110 @@
+#ifndef POWER_MONITOR_H
+#define POWER_MONITOR_H
+
+#include <Arduino.h>
+
+/**
+ * @brief Current draw of each component, used to estimate consumption
+ *
+ * All currents are in microamps. Values are typical datasheet figures,
+ * adjust them to match measurements on your own skull.
+ */
+typedef struct
+{
+    uint16_t supplyMillivolts;   // Supply voltage, used to compute energy
+    uint32_t cpuActive;          // ESP32 running (including delay())
+    uint32_t cpuLightSleep;      // ESP32 in light sleep
+    uint8_t displayDevices;      // Number of MAX7219
+    uint32_t displayQuiescent;   // Per MAX7219 in normal operation, LEDs off
+    uint32_t displayShutdown;    // Per MAX7219 in SHUTDOWN mode
+    uint32_t displaySegmentPeak; // LED peak segment current (set by RSET)
+    uint32_t audioIdle;          // DFPlayer idle
+    uint32_t audioPlaying;       // DFPlayer playing, depends on volume and speaker
+} PowerModel;
+
+/**
+ * @brief Snapshot of what draws power during a loop iteration
+ */
+typedef struct
+{
+    uint8_t litPixels;     // Number of lit LEDs on all displays
+    uint8_t brightness;    // MAX7219 intensity level (0-15)
+    bool displayShutdown;  // True if the displays are in SHUTDOWN mode
+    bool audioPlaying;     // True if a sound is playing
+} PowerState;
+
+/**
+ * @brief PowerMonitor class estimating power consumption from duty cycles
+ *
+ * Accumulates the charge drawn by the CPU, the displays and the audio
+ * module from the time spent in each state, and periodically prints the
+ * duty cycles and the estimated average current and energy per hour.
+ * There is no current sensor: figures are estimates from the PowerModel.
+ */
+class PowerMonitor
+{
+public:
+    /**
+     * @brief Construct a new PowerMonitor object
+     *
+     * @param model Current draw of each component
+     */
+    PowerMonitor(const PowerModel &model);
+
+    /**
+     * @brief Account for one loop iteration
+     *
+     * @param elapsedUs Total duration of the iteration (us)
+     * @param sleptUs Part of elapsedUs spent in light sleep (us)
+     * @param state What was drawing power during the iteration
+     */
+    void account(uint32_t elapsedUs, uint32_t sleptUs, const PowerState &state);
+
+    /**
+     * @brief Print a report and start a new period when the interval elapsed
+     *
+     * @param out Where to print the report (e.g. Serial)
+     * @param intervalMs Reporting interval (ms)
+     *
+     * @return true if a report was printed
+     */
+    bool update(Print &out, unsigned long intervalMs);
+
+    /**
+     * @brief Print the report for the current period
+     *
+     * @param out Where to print the report (e.g. Serial)
+     */
+    void report(Print &out);
+
+    /**
+     * @brief Start a new accounting period
+     */
+    void reset();
+
+private:
+    PowerModel model;
+
+    unsigned long periodStart;
+
+    // Durations (us)
+    uint64_t totalTime;
+    uint64_t sleepTime;
+    uint64_t displayShutdownTime;
+    uint64_t audioPlayingTime;
+
+    // Charge (uA.us) per component
+    uint64_t cpuCharge;
+    uint64_t displayCharge;
+    uint64_t audioCharge;
+
+    // Lit LEDs integrated over time (LED.us), for the average
+    uint64_t litPixelTime;
+
+    /**
+     * @brief Percentage of the period
+     */
+    uint32_t percent(uint64_t part);
+};
+
+#endif // POWER_MONITOR_H
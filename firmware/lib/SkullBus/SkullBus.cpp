@@ -0,0 +1,360 @@
+#include "SkullBus.h"
+
+SkullBus::SkullBus(SkullBusPort &port) : port(port), parser()
+{
+    role = SKULL_BUS_OFF;
+    id = SKULL_BUS_LEADER_ID;
+    config.skullCount = 1;
+    config.baudRate = 115200;
+    config.slotMs = 0;
+    config.tokenGapMinMs = 0;
+    config.tokenGapMaxMs = 0;
+    nowUs = 0;
+    frameTimeUs = 0;
+    synced = false;
+    offsetUs = 0;
+    windowMaxUs = 0;
+    windowCount = 0;
+    lastBeaconUs = 0;
+    holder = SKULL_BUS_NO_HOLDER;
+    nextHolder = SKULL_BUS_LEADER_ID;
+    tokenStartUs = 0;
+    slotUs = 0;
+    gapUs = 0;
+    holding = false;
+    spoke = false;
+    gapSeed = 1;
+    commandHead = 0;
+    commandCount = 0;
+    stats = {0, 0, 0, 0, 0};
+}
+
+/**
+ * @brief Set the role of this skull
+ */
+void SkullBus::begin(SkullBusRole role, uint8_t id, const SkullBusConfig &config, uint32_t nowUs)
+{
+    this->role = role;
+    this->id = id;
+    this->config = config;
+    if (this->config.skullCount == 0)
+    {
+        this->config.skullCount = 1;
+    }
+    if (this->config.tokenGapMaxMs < this->config.tokenGapMinMs)
+    {
+        this->config.tokenGapMaxMs = this->config.tokenGapMinMs;
+    }
+    this->nowUs = nowUs;
+    // 10 bits per byte (8N1)
+    frameTimeUs = (uint32_t)SKULL_BUS_FRAME_SIZE * 10 * 1000000UL / config.baudRate;
+    gapSeed = nowUs | 1;
+
+    if (role == SKULL_BUS_LEADER)
+    {
+        // First beacon right away, first slot after a gap
+        lastBeaconUs = nowUs - BEACON_INTERVAL;
+        nextHolder = SKULL_BUS_LEADER_ID;
+        startGap();
+    }
+}
+
+/**
+ * @brief Receive frames, send beacons and tokens
+ */
+void SkullBus::update(uint32_t nowUs, bool speaking)
+{
+    if (role == SKULL_BUS_OFF)
+    {
+        return;
+    }
+    this->nowUs = nowUs;
+
+    int byte;
+    while ((byte = port.read()) >= 0)
+    {
+        if (parser.push((uint8_t)byte))
+        {
+            stats.framesReceived++;
+            handleFrame(parser.frame());
+        }
+    }
+    stats.framesDropped = parser.getDropped();
+
+    if (role == SKULL_BUS_LEADER)
+    {
+        if (nowUs - lastBeaconUs >= BEACON_INTERVAL)
+        {
+            lastBeaconUs = nowUs;
+            send(SKULL_BUS_BEACON, nowUs, 0, 0);
+        }
+
+        if (holder == SKULL_BUS_NO_HOLDER)
+        {
+            if (nowUs - tokenStartUs >= gapUs)
+            {
+                grantToken(nextHolder, config.slotMs);
+                nextHolder = (nextHolder + 1) % config.skullCount;
+            }
+        }
+        else if (nowUs - tokenStartUs >= slotUs)
+        {
+            // Holder did not give the token back (sound too long, frame lost...)
+            holding = false;
+            startGap();
+        }
+    }
+    else
+    {
+        if (synced && nowUs - lastBeaconUs >= LEADER_TIMEOUT)
+        {
+            // Leader gone: standalone until it is back
+            synced = false;
+            holding = false;
+            stats.leaderLost++;
+        }
+        if (holding && nowUs - tokenStartUs >= slotUs)
+        {
+            holding = false; // Slot over, the leader moved on
+        }
+    }
+
+    // Give the token back once the sound played in the slot is over
+    if (holding)
+    {
+        if (speaking)
+        {
+            spoke = true;
+        }
+        else if (spoke)
+        {
+            releaseToken();
+        }
+    }
+}
+
+/**
+ * @brief Get the next group command received
+ *
+ * @return false if there is none
+ */
+bool SkullBus::takeCommand(SkullBusCommand &command)
+{
+    if (commandCount == 0)
+    {
+        return false;
+    }
+    command = commands[commandHead];
+    commandHead = (commandHead + 1) % SKULL_BUS_COMMAND_QUEUE;
+    commandCount--;
+    return true;
+}
+
+/**
+ * @brief Broadcast a group command (leader only)
+ *
+ * @return false if not the leader
+ */
+bool SkullBus::broadcast(uint8_t type, uint32_t dueUs, uint8_t a, uint8_t b)
+{
+    if (role != SKULL_BUS_LEADER)
+    {
+        return false;
+    }
+    send(type, dueUs, a, b);
+    queueCommand(type, dueUs, a, b);
+    return true;
+}
+
+/**
+ * @brief Take the speaking token for the leader
+ */
+void SkullBus::claimToken()
+{
+    if (role == SKULL_BUS_LEADER && holder != SKULL_BUS_LEADER_ID)
+    {
+        grantToken(SKULL_BUS_LEADER_ID, config.slotMs);
+    }
+}
+
+/**
+ * @brief Give the token back before the end of the slot
+ */
+void SkullBus::releaseToken()
+{
+    if (!holding)
+    {
+        return;
+    }
+    holding = false;
+    if (role == SKULL_BUS_LEADER)
+    {
+        startGap();
+    }
+    else
+    {
+        // Only the holder sends on the bus: no collision with other followers
+        send(SKULL_BUS_RELEASE, 0, 0, 0);
+    }
+}
+
+/**
+ * @brief Check if this skull may play a sound
+ */
+bool SkullBus::maySpeak()
+{
+    return !isActive() || holding;
+}
+
+/**
+ * @brief Check if the skull is part of a working bus
+ */
+bool SkullBus::isActive()
+{
+    return role == SKULL_BUS_LEADER || (role == SKULL_BUS_FOLLOWER && synced);
+}
+
+/**
+ * @brief Convert a leader clock time to the local clock
+ */
+uint32_t SkullBus::toLocal(uint32_t leaderUs)
+{
+    return leaderUs - (uint32_t)offsetUs;
+}
+
+SkullBusStats SkullBus::getStats()
+{
+    return stats;
+}
+
+void SkullBus::send(uint8_t type, uint32_t time, uint8_t a, uint8_t b)
+{
+    SkullBusFrame frame = {type, id, time, a, b};
+    uint8_t bytes[SKULL_BUS_FRAME_SIZE];
+    skullBusEncode(frame, bytes);
+    port.write(bytes, SKULL_BUS_FRAME_SIZE);
+}
+
+void SkullBus::handleFrame(const SkullBusFrame &frame)
+{
+    if (role == SKULL_BUS_LEADER)
+    {
+        if (frame.type == SKULL_BUS_RELEASE && frame.source == holder)
+        {
+            startGap();
+        }
+        return; // Another leader on the bus is a wiring mistake, ignore it
+    }
+
+    if (frame.source != SKULL_BUS_LEADER_ID)
+    {
+        return; // Token release of another follower
+    }
+
+    switch (frame.type)
+    {
+    case SKULL_BUS_BEACON:
+        syncClock(frame.time);
+        break;
+
+    case SKULL_BUS_GAZE:
+    case SKULL_BUS_SCENE:
+        if (synced)
+        {
+            queueCommand(frame.type, toLocal(frame.time), frame.a, frame.b);
+        }
+        break;
+
+    case SKULL_BUS_TOKEN:
+        holding = synced && (frame.a == id);
+        spoke = false;
+        tokenStartUs = nowUs;
+        slotUs = frame.time * 1000UL;
+        break;
+
+    default:
+        break;
+    }
+}
+
+/**
+ * @brief Update the clock offset from a beacon
+ *
+ * A beacon is read late by up to a loop period, which makes the offset look
+ * smaller than it is: the largest (least delayed) offset of a window of
+ * beacons is kept, then applied at the end of the window.
+ */
+void SkullBus::syncClock(uint32_t leaderUs)
+{
+    // The beacon was stamped before being sent, add the transfer time
+    int32_t sample = (int32_t)(leaderUs + frameTimeUs - nowUs);
+    lastBeaconUs = nowUs;
+
+    if (!synced)
+    {
+        synced = true;
+        offsetUs = sample;
+        windowMaxUs = sample;
+        windowCount = 1;
+        return;
+    }
+
+    if (windowCount == 0 || sample - windowMaxUs > 0)
+    {
+        windowMaxUs = sample;
+    }
+    if (++windowCount >= SYNC_WINDOW)
+    {
+        uint32_t correction = (uint32_t)(windowMaxUs > offsetUs ? windowMaxUs - offsetUs : offsetUs - windowMaxUs);
+        if (correction > stats.maxCorrectionUs)
+        {
+            stats.maxCorrectionUs = correction;
+        }
+        offsetUs = windowMaxUs;
+        windowCount = 0;
+    }
+}
+
+void SkullBus::queueCommand(uint8_t type, uint32_t dueUs, uint8_t a, uint8_t b)
+{
+    if (commandCount >= SKULL_BUS_COMMAND_QUEUE)
+    {
+        return; // Not taken, drop the newest
+    }
+    SkullBusCommand &command = commands[(commandHead + commandCount) % SKULL_BUS_COMMAND_QUEUE];
+    command.type = type;
+    command.dueUs = dueUs;
+    command.a = a;
+    command.b = b;
+    commandCount++;
+}
+
+/**
+ * @brief Grant the speaking token (leader)
+ */
+void SkullBus::grantToken(uint8_t skull, uint32_t slotMs)
+{
+    holder = skull;
+    tokenStartUs = nowUs;
+    slotUs = slotMs * 1000UL;
+    holding = (skull == id);
+    spoke = false;
+    stats.tokensGranted++;
+    send(SKULL_BUS_TOKEN, slotMs, skull, 0);
+}
+
+/**
+ * @brief Start a silence before the next slot (leader)
+ */
+void SkullBus::startGap()
+{
+    holder = SKULL_BUS_NO_HOLDER;
+    tokenStartUs = nowUs;
+
+    // xorshift32, no need for Arduino's random() here
+    gapSeed ^= gapSeed << 13;
+    gapSeed ^= gapSeed >> 17;
+    gapSeed ^= gapSeed << 5;
+    uint32_t range = config.tokenGapMaxMs - config.tokenGapMinMs + 1;
+    gapUs = (config.tokenGapMinMs + gapSeed % range) * 1000UL;
+}
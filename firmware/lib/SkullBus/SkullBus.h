@@ -0,0 +1,212 @@
+#ifndef SKULL_BUS_H
+#define SKULL_BUS_H
+
+// Pure C++ (no Arduino dependency): time is passed in and bytes go through a
+// SkullBusPort, so several skulls can be simulated on the host
+
+#include <stdint.h>
+#include "SkullBusProtocol.h"
+
+/**
+ * @brief Byte link to the bus (UART, RS-485 transceiver, pseudo-terminal...)
+ */
+class SkullBusPort
+{
+public:
+    virtual ~SkullBusPort() {}
+
+    /**
+     * @brief Read one received byte, never blocks
+     *
+     * @return The byte, or -1 if none is available
+     */
+    virtual int read() = 0;
+
+    /**
+     * @brief Send bytes, never blocks (a frame fits in the UART FIFO)
+     */
+    virtual void write(const uint8_t *data, uint8_t length) = 0;
+};
+
+/**
+ * @brief Role of a skull on the bus
+ */
+enum SkullBusRole
+{
+    SKULL_BUS_OFF,      // Standalone skull, no bus
+    SKULL_BUS_LEADER,   // Sends the clock, the group commands and the speaking tokens
+    SKULL_BUS_FOLLOWER, // Follows the leader, standalone while it is not heard
+};
+
+typedef struct
+{
+    uint8_t skullCount;      // Skulls on the bus, leader included
+    uint32_t baudRate;       // Bus speed, to compensate the frame transfer time
+    uint16_t slotMs;         // Longest time a skull may hold the speaking token
+    uint16_t tokenGapMinMs;  // Silence between two speaking slots, random
+    uint16_t tokenGapMaxMs;  //   between these two values
+} SkullBusConfig;
+
+/**
+ * @brief Group command, to apply at a shared time
+ */
+typedef struct
+{
+    uint8_t type;   // SKULL_BUS_GAZE or SKULL_BUS_SCENE
+    uint32_t dueUs; // Local time (micros()) when to apply it
+    uint8_t a;
+    uint8_t b;
+} SkullBusCommand;
+
+typedef struct
+{
+    uint32_t framesReceived;  // Valid frames
+    uint32_t framesDropped;   // Frames with a bad CRC (noise, collisions)
+    uint32_t leaderLost;      // Times the follower stopped hearing the leader
+    uint32_t maxCorrectionUs; // Largest clock correction applied
+    uint32_t tokensGranted;   // Speaking slots granted (leader)
+} SkullBusStats;
+
+// Commands waiting to be taken with takeCommand()
+#define SKULL_BUS_COMMAND_QUEUE 4
+
+/**
+ * @brief SkullBus class, synchronizes several skulls over a shared bus
+ *
+ * The leader broadcasts its clock every second, group commands (gaze,
+ * scenes) stamped with the time at which all skulls must apply them, and
+ * a speaking token granted to one skull at a time in turn. Followers keep
+ * the offset between their clock and the leader one, and only talk on the
+ * bus to give the token back: with a half-duplex RS-485 bus, the leader and
+ * the token holder are the only senders.
+ *
+ * A follower that does not hear the leader any more (or has not heard it
+ * yet) behaves as a standalone skull.
+ */
+class SkullBus
+{
+public:
+    /**
+     * @brief Construct a new SkullBus object
+     *
+     * @param port Link to the bus
+     */
+    SkullBus(SkullBusPort &port);
+
+    /**
+     * @brief Set the role of this skull
+     *
+     * @param role Leader, follower or off
+     * @param id Skull id: SKULL_BUS_LEADER_ID for the leader, 1 to skullCount - 1 for followers
+     * @param config Bus settings, the same on all skulls
+     * @param nowUs Current time (us)
+     */
+    void begin(SkullBusRole role, uint8_t id, const SkullBusConfig &config, uint32_t nowUs);
+
+    /**
+     * @brief Receive frames, send beacons and tokens (call this in loop())
+     *
+     * @param nowUs Current time (us)
+     * @param speaking This skull is playing a sound, the token is given back
+     *                 when the sound ends
+     */
+    void update(uint32_t nowUs, bool speaking);
+
+    /**
+     * @brief Get the next group command received
+     *
+     * @param command Filled with the command, due time converted to the local clock
+     *
+     * @return false if there is none
+     */
+    bool takeCommand(SkullBusCommand &command);
+
+    /**
+     * @brief Broadcast a group command (leader only)
+     *
+     * The command is also queued for the leader itself, see takeCommand().
+     *
+     * @param type SKULL_BUS_GAZE or SKULL_BUS_SCENE
+     * @param dueUs When all skulls apply it (leader clock), leave time for the transfer
+     *
+     * @return false if not the leader
+     */
+    bool broadcast(uint8_t type, uint32_t dueUs, uint8_t a, uint8_t b);
+
+    /**
+     * @brief Take the speaking token for the leader, e.g. for a group scene
+     */
+    void claimToken();
+
+    /**
+     * @brief Give the token back before the end of the slot
+     */
+    void releaseToken();
+
+    /**
+     * @brief Check if this skull may play a sound
+     *
+     * @return true if holding the token, or if not synchronized with a leader
+     */
+    bool maySpeak();
+
+    /**
+     * @brief Check if the skull is part of a working bus
+     *
+     * @return true for the leader, and for a follower hearing the leader
+     */
+    bool isActive();
+
+    /**
+     * @brief Convert a leader clock time to the local clock
+     */
+    uint32_t toLocal(uint32_t leaderUs);
+
+    SkullBusStats getStats();
+
+private:
+    SkullBusPort &port;
+    SkullBusParser parser;
+    SkullBusRole role;
+    uint8_t id;
+    SkullBusConfig config;
+    uint32_t nowUs;
+    uint32_t frameTimeUs; // Time to transfer one frame
+
+    // Clock (followers): leader clock = local clock + offset
+    bool synced;
+    int32_t offsetUs;
+    int32_t windowMaxUs;  // Least delayed sample of the current window
+    uint8_t windowCount;
+    uint32_t lastBeaconUs; // Leader: when sent, follower: when received
+
+    // Speaking token
+    uint8_t holder;        // Leader: current holder, SKULL_BUS_NO_HOLDER during a gap
+    uint8_t nextHolder;    // Leader: next skull in turn
+    uint32_t tokenStartUs; // When the current slot or gap started
+    uint32_t slotUs;       // Length of the current slot (followers: as sent by the leader)
+    uint32_t gapUs;        // Length of the current gap (leader)
+    bool holding;          // This skull holds the token
+    bool spoke;            // A sound was played in the current slot
+    uint32_t gapSeed;      // Gap generator state
+
+    SkullBusCommand commands[SKULL_BUS_COMMAND_QUEUE];
+    uint8_t commandHead;
+    uint8_t commandCount;
+
+    SkullBusStats stats;
+
+    static const uint8_t SKULL_BUS_NO_HOLDER = 0xFF;
+    static const uint32_t BEACON_INTERVAL = 1000000;  // us
+    static const uint32_t LEADER_TIMEOUT = 3500000;   // us, a bit more than 3 beacons
+    static const uint8_t SYNC_WINDOW = 8;             // Beacons per clock correction
+
+    void send(uint8_t type, uint32_t time, uint8_t a, uint8_t b);
+    void handleFrame(const SkullBusFrame &frame);
+    void syncClock(uint32_t leaderUs);
+    void queueCommand(uint8_t type, uint32_t dueUs, uint8_t a, uint8_t b);
+    void grantToken(uint8_t skull, uint32_t slotMs);
+    void startGap();
+};
+
+#endif // SKULL_BUS_H
@@ -0,0 +1,119 @@
+#include "SkullBusProtocol.h"
+
+#define FRAME_START 0xA5
+
+/**
+ * @brief Compute the CRC-8 (polynomial 0x07) of a frame, start marker excluded
+ */
+static uint8_t crc8(const uint8_t *frame)
+{
+    uint8_t crc = 0;
+    for (uint8_t i = 1; i < SKULL_BUS_FRAME_SIZE - 1; i++)
+    {
+        crc ^= frame[i];
+        for (uint8_t bit = 0; bit < 8; bit++)
+        {
+            crc = (crc & 0x80) ? (crc << 1) ^ 0x07 : crc << 1;
+        }
+    }
+    return crc;
+}
+
+/**
+ * @brief Encode a bus frame
+ */
+void skullBusEncode(const SkullBusFrame &frame, uint8_t *out)
+{
+    out[0] = FRAME_START;
+    out[1] = frame.type;
+    out[2] = frame.source;
+    out[3] = frame.time & 0xFF;
+    out[4] = (frame.time >> 8) & 0xFF;
+    out[5] = (frame.time >> 16) & 0xFF;
+    out[6] = frame.time >> 24;
+    out[7] = frame.a;
+    out[8] = frame.b;
+    out[9] = crc8(out);
+}
+
+SkullBusParser::SkullBusParser()
+{
+    index = 0;
+    dropped = 0;
+    last.type = 0;
+    last.source = 0;
+    last.time = 0;
+    last.a = 0;
+    last.b = 0;
+}
+
+/**
+ * @brief Drop any partially received frame
+ */
+void SkullBusParser::reset()
+{
+    index = 0;
+}
+
+/**
+ * @brief Feed one received byte
+ *
+ * @return true if a valid frame was completed
+ */
+bool SkullBusParser::push(uint8_t byte)
+{
+    if (index == 0 && byte != FRAME_START)
+    {
+        return false; // Wait for a start marker
+    }
+
+    buffer[index++] = byte;
+    if (index < SKULL_BUS_FRAME_SIZE)
+    {
+        return false;
+    }
+    index = 0;
+
+    if (buffer[SKULL_BUS_FRAME_SIZE - 1] != crc8(buffer))
+    {
+        dropped++;
+        // The start marker may have been a data byte of a truncated frame:
+        // restart from the next start marker already received, if any
+        for (uint8_t i = 1; i < SKULL_BUS_FRAME_SIZE; i++)
+        {
+            if (buffer[i] == FRAME_START)
+            {
+                for (uint8_t j = i; j < SKULL_BUS_FRAME_SIZE; j++)
+                {
+                    buffer[index++] = buffer[j];
+                }
+                break;
+            }
+        }
+        return false;
+    }
+
+    last.type = buffer[1];
+    last.source = buffer[2];
+    last.time = (uint32_t)buffer[3] | ((uint32_t)buffer[4] << 8) |
+                ((uint32_t)buffer[5] << 16) | ((uint32_t)buffer[6] << 24);
+    last.a = buffer[7];
+    last.b = buffer[8];
+    return true;
+}
+
+/**
+ * @brief Get the last valid frame
+ */
+const SkullBusFrame &SkullBusParser::frame()
+{
+    return last;
+}
+
+/**
+ * @brief Get the number of dropped (invalid) frames
+ */
+uint32_t SkullBusParser::getDropped()
+{
+    return dropped;
+}
@@ -0,0 +1,88 @@
+#ifndef SKULL_BUS_PROTOCOL_H
+#define SKULL_BUS_PROTOCOL_H
+
+#include <stdint.h>
+
+// Every bus message is a 10-byte frame, times are little endian:
+// A5 TYPE SOURCE TIME0 TIME1 TIME2 TIME3 A B CRC8
+#define SKULL_BUS_FRAME_SIZE 10
+
+// Source id of the leader, followers are 1 to (skull count - 1)
+#define SKULL_BUS_LEADER_ID 0
+
+/**
+ * @brief Bus messages
+ */
+enum SkullBusMessage
+{
+    SKULL_BUS_BEACON = 0x01,  // Leader → all, time: leader clock (us)
+    SKULL_BUS_GAZE = 0x02,    // Leader → all, time: due (leader clock), a: x, b: y
+    SKULL_BUS_SCENE = 0x03,   // Leader → all, time: due (leader clock), a: scene index
+    SKULL_BUS_TOKEN = 0x04,   // Leader → all, time: slot length (ms), a: id of the skull allowed to speak
+    SKULL_BUS_RELEASE = 0x05, // Token holder → leader, done speaking
+};
+
+/**
+ * @brief Decoded bus frame
+ */
+typedef struct
+{
+    uint8_t type;
+    uint8_t source;
+    uint32_t time;
+    uint8_t a;
+    uint8_t b;
+} SkullBusFrame;
+
+/**
+ * @brief Encode a bus frame
+ *
+ * @param frame Frame to encode
+ * @param out Output buffer of SKULL_BUS_FRAME_SIZE bytes
+ */
+void skullBusEncode(const SkullBusFrame &frame, uint8_t *out);
+
+/**
+ * @brief Incremental bus frame parser
+ *
+ * Fed one byte at a time, never blocks. Bytes before a start marker are
+ * skipped and frames with a bad CRC are dropped, so the parser
+ * re-synchronizes by itself after lost or corrupted bytes.
+ */
+class SkullBusParser
+{
+public:
+    SkullBusParser();
+
+    /**
+     * @brief Drop any partially received frame
+     */
+    void reset();
+
+    /**
+     * @brief Feed one received byte
+     *
+     * @param byte Received byte
+     *
+     * @return true if a valid frame was completed, see frame()
+     */
+    bool push(uint8_t byte);
+
+    /**
+     * @brief Get the last valid frame
+     */
+    const SkullBusFrame &frame();
+
+    /**
+     * @brief Get the number of dropped (invalid) frames
+     */
+    uint32_t getDropped();
+
+private:
+    uint8_t buffer[SKULL_BUS_FRAME_SIZE];
+    uint8_t index;
+    SkullBusFrame last;
+    uint32_t dropped;
+};
+
+#endif // SKULL_BUS_PROTOCOL_H
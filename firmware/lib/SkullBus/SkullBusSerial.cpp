@@ -0,0 +1,33 @@
+#include "SkullBusSerial.h"
+#include <driver/uart.h>
+
+SkullBusSerial::SkullBusSerial(uint8_t uartNum, int8_t rxPin, int8_t txPin, int8_t dePin) : serial(uartNum)
+{
+    this->rxPin = rxPin;
+    this->txPin = txPin;
+    this->dePin = dePin;
+}
+
+/**
+ * @brief Start the UART, in RS-485 half-duplex mode with a transceiver
+ */
+void SkullBusSerial::begin(uint32_t baudRate)
+{
+    serial.begin(baudRate, SERIAL_8N1, rxPin, txPin);
+    if (dePin >= 0)
+    {
+        serial.setPins(-1, -1, -1, dePin); // RTS drives DE
+        serial.setMode(UART_MODE_RS485_HALF_DUPLEX);
+    }
+}
+
+int SkullBusSerial::read()
+{
+    return serial.available() ? serial.read() : -1;
+}
+
+void SkullBusSerial::write(const uint8_t *data, uint8_t length)
+{
+    // 10 bytes always fit in the UART hardware FIFO: does not block
+    serial.write(data, length);
+}
@@ -0,0 +1,44 @@
+#ifndef SKULL_BUS_SERIAL_H
+#define SKULL_BUS_SERIAL_H
+
+#include <HardwareSerial.h>
+#include "SkullBus.h"
+
+/**
+ * @brief Bus link over an ESP32 UART, with an optional RS-485 transceiver
+ *
+ * With a driver enable pin, the UART runs in RS-485 half-duplex mode: the
+ * hardware drives DE (RTS) while sending. Without one, only two skulls can
+ * be wired together (TX to RX both ways).
+ */
+class SkullBusSerial : public SkullBusPort
+{
+public:
+    /**
+     * @brief Construct a new SkullBusSerial object
+     *
+     * @param uartNum UART to use
+     * @param rxPin RX pin (RO of the transceiver)
+     * @param txPin TX pin (DI of the transceiver)
+     * @param dePin Driver enable pin (DE and /RE of the transceiver), -1 without transceiver
+     */
+    SkullBusSerial(uint8_t uartNum, int8_t rxPin, int8_t txPin, int8_t dePin);
+
+    /**
+     * @brief Start the UART
+     *
+     * @param baudRate Bus speed, the same on all skulls
+     */
+    void begin(uint32_t baudRate);
+
+    int read() override;
+    void write(const uint8_t *data, uint8_t length) override;
+
+private:
+    HardwareSerial serial;
+    int8_t rxPin;
+    int8_t txPin;
+    int8_t dePin;
+};
+
+#endif // SKULL_BUS_SERIAL_H
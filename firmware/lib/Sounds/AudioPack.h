@@ -0,0 +1,33 @@
+#ifndef AUDIO_PACK_H
+#define AUDIO_PACK_H
+
+#include <stdint.h>
+
+// Layout of the audio partition, written by tools/audio_pack.py:
+// AudioPackHeader, clipCount x AudioPackClip, then the clips. Little endian,
+// clips aligned on 4 bytes, offsets from the start of the partition.
+
+#define AUDIO_PACK_MAGIC 0x44414B53 // "SKAD"
+#define AUDIO_PACK_VERSION 1
+
+typedef struct
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t clipCount;
+    uint32_t sampleRate; // Same for all clips (Hz)
+} AudioPackHeader;
+
+typedef struct
+{
+    uint8_t folder;     // DFPlayer folder the clip comes from
+    uint8_t track;      // DFPlayer track number
+    uint16_t blockSize; // IMA-ADPCM block size (bytes)
+    uint32_t offset;    // Start of the encoded blocks
+    uint32_t samples;   // Number of samples
+} AudioPackClip;
+
+static_assert(sizeof(AudioPackHeader) == 12, "AudioPackHeader layout");
+static_assert(sizeof(AudioPackClip) == 12, "AudioPackClip layout");
+
+#endif // AUDIO_PACK_H
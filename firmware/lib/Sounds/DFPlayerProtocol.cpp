@@ -0,0 +1,119 @@
+#include "DFPlayerProtocol.h"
+
+#define FRAME_START 0x7E
+#define FRAME_VERSION 0xFF
+#define FRAME_LENGTH 0x06
+#define FRAME_END 0xEF
+
+/**
+ * @brief Compute the checksum of a frame
+ *
+ * Two's complement of the sum of version, length, command, feedback and
+ * parameter bytes.
+ */
+static uint16_t checksum(const uint8_t *frame)
+{
+    uint16_t sum = 0;
+    for (uint8_t i = 1; i < 7; i++)
+    {
+        sum += frame[i];
+    }
+    return (uint16_t)(0 - sum);
+}
+
+/**
+ * @brief Encode a DFPlayer frame
+ */
+void dfPlayerEncode(uint8_t command, uint16_t parameter, bool feedback, uint8_t *out)
+{
+    out[0] = FRAME_START;
+    out[1] = FRAME_VERSION;
+    out[2] = FRAME_LENGTH;
+    out[3] = command;
+    out[4] = feedback ? 0x01 : 0x00;
+    out[5] = parameter >> 8;
+    out[6] = parameter & 0xFF;
+    uint16_t sum = checksum(out);
+    out[7] = sum >> 8;
+    out[8] = sum & 0xFF;
+    out[9] = FRAME_END;
+}
+
+DFPlayerParser::DFPlayerParser()
+{
+    index = 0;
+    dropped = 0;
+    last.command = 0;
+    last.feedback = false;
+    last.parameter = 0;
+}
+
+/**
+ * @brief Drop any partially received frame
+ */
+void DFPlayerParser::reset()
+{
+    index = 0;
+}
+
+/**
+ * @brief Feed one received byte
+ *
+ * @return true if a valid frame was completed
+ */
+bool DFPlayerParser::push(uint8_t byte)
+{
+    if (index == 0 && byte != FRAME_START)
+    {
+        return false; // Wait for a start marker
+    }
+
+    buffer[index++] = byte;
+    if (index < DFPLAYER_FRAME_SIZE)
+    {
+        return false;
+    }
+    index = 0;
+
+    uint16_t sum = ((uint16_t)buffer[7] << 8) | buffer[8];
+    if (buffer[1] != FRAME_VERSION || buffer[2] != FRAME_LENGTH ||
+        buffer[9] != FRAME_END || sum != checksum(buffer))
+    {
+        dropped++;
+        // The start marker may have been a data byte of a truncated frame:
+        // restart from the next start marker already received, if any
+        for (uint8_t i = 1; i < DFPLAYER_FRAME_SIZE; i++)
+        {
+            if (buffer[i] == FRAME_START)
+            {
+                for (uint8_t j = i; j < DFPLAYER_FRAME_SIZE; j++)
+                {
+                    buffer[index++] = buffer[j];
+                }
+                break;
+            }
+        }
+        return false;
+    }
+
+    last.command = buffer[3];
+    last.feedback = buffer[4] != 0;
+    last.parameter = ((uint16_t)buffer[5] << 8) | buffer[6];
+    return true;
+}
+
+/**
+ * @brief Get the last valid frame
+ */
+const DFPlayerFrame &DFPlayerParser::frame()
+{
+    return last;
+}
+
+/**
+ * @brief Get the number of dropped (invalid) frames
+ */
+uint32_t DFPlayerParser::getDropped()
+{
+    return dropped;
+}
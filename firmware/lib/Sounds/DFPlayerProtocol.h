@@ -0,0 +1,125 @@
+#ifndef DFPLAYER_PROTOCOL_H
+#define DFPLAYER_PROTOCOL_H
+
+#include <stdint.h>
+
+// Every DFPlayer message, in both directions, is a 10-byte frame:
+// 7E FF 06 CMD FEEDBACK PARAM_H PARAM_L CHECKSUM_H CHECKSUM_L EF
+#define DFPLAYER_FRAME_SIZE 10
+
+/**
+ * @brief DFPlayer commands (ESP32 → DFPlayer)
+ */
+enum DFPlayerCommand
+{
+    DFPLAYER_CMD_VOLUME = 0x06,       // Parameter: volume (0-30)
+    DFPLAYER_CMD_EQ = 0x07,           // Parameter: DFPlayerEq
+    DFPLAYER_CMD_RESET = 0x0C,        // Module reboots, then sends DFPLAYER_MSG_ONLINE
+    DFPLAYER_CMD_PLAY_FOLDER = 0x0F,  // Parameter: folder << 8 | track
+    DFPLAYER_CMD_QUERY_STATUS = 0x42, // Reply: DFPLAYER_MSG_STATUS
+};
+
+/**
+ * @brief DFPlayer messages (DFPlayer → ESP32)
+ */
+enum DFPlayerMessage
+{
+    DFPLAYER_MSG_CARD_INSERTED = 0x3A,
+    DFPLAYER_MSG_CARD_REMOVED = 0x3B,
+    DFPLAYER_MSG_TRACK_FINISHED = 0x3D, // Parameter: track number
+    DFPLAYER_MSG_ONLINE = 0x3F,         // Parameter: bitmask of online storages (0x02 = SD)
+    DFPLAYER_MSG_ERROR = 0x40,          // Parameter: DFPlayerError
+    DFPLAYER_MSG_ACK = 0x41,
+    DFPLAYER_MSG_STATUS = 0x42,         // Parameter low byte: 0 stopped, 1 playing, 2 paused
+};
+
+/**
+ * @brief DFPlayer error codes (parameter of DFPLAYER_MSG_ERROR)
+ */
+enum DFPlayerError
+{
+    DFPLAYER_ERROR_BUSY = 0x01, // Module is (re)initializing
+    DFPLAYER_ERROR_SLEEPING = 0x02,
+    DFPLAYER_ERROR_SERIAL = 0x03,
+    DFPLAYER_ERROR_CHECKSUM = 0x04,
+    DFPLAYER_ERROR_FILE_INDEX = 0x05,
+    DFPLAYER_ERROR_FILE_MISMATCH = 0x06,
+};
+
+/**
+ * @brief DFPlayer equalizer presets (parameter of DFPLAYER_CMD_EQ)
+ */
+enum DFPlayerEq
+{
+    DFPLAYER_EQ_NORMAL = 0,
+    DFPLAYER_EQ_POP = 1,
+    DFPLAYER_EQ_ROCK = 2,
+    DFPLAYER_EQ_JAZZ = 3,
+    DFPLAYER_EQ_CLASSIC = 4,
+    DFPLAYER_EQ_BASS = 5,
+};
+
+/**
+ * @brief Decoded DFPlayer frame
+ */
+typedef struct
+{
+    uint8_t command;
+    bool feedback;
+    uint16_t parameter;
+} DFPlayerFrame;
+
+/**
+ * @brief Encode a DFPlayer frame
+ *
+ * @param command Command byte
+ * @param parameter 16-bit parameter
+ * @param feedback Ask the module for an ACK (DFPLAYER_MSG_ACK)
+ * @param out Output buffer of DFPLAYER_FRAME_SIZE bytes
+ */
+void dfPlayerEncode(uint8_t command, uint16_t parameter, bool feedback, uint8_t *out);
+
+/**
+ * @brief Incremental DFPlayer frame parser
+ *
+ * Fed one byte at a time, never blocks. Bytes before a start marker are
+ * skipped and invalid frames are dropped, so the parser re-synchronizes by
+ * itself after lost or corrupted bytes.
+ */
+class DFPlayerParser
+{
+public:
+    DFPlayerParser();
+
+    /**
+     * @brief Drop any partially received frame
+     */
+    void reset();
+
+    /**
+     * @brief Feed one received byte
+     *
+     * @param byte Received byte
+     *
+     * @return true if a valid frame was completed, see frame()
+     */
+    bool push(uint8_t byte);
+
+    /**
+     * @brief Get the last valid frame
+     */
+    const DFPlayerFrame &frame();
+
+    /**
+     * @brief Get the number of dropped (invalid) frames
+     */
+    uint32_t getDropped();
+
+private:
+    uint8_t buffer[DFPLAYER_FRAME_SIZE];
+    uint8_t index;
+    DFPlayerFrame last;
+    uint32_t dropped;
+};
+
+#endif // DFPLAYER_PROTOCOL_H
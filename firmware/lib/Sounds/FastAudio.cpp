@@ -0,0 +1,302 @@
+#include "FastAudio.h"
+
+// The ESP32 DAC DMA sends 16-bit slots, the driver spreads the 8-bit samples
+#if SOC_DAC_DMA_16BIT_ALIGN
+#define DAC_BYTES_PER_SAMPLE 2
+#else
+#define DAC_BYTES_PER_SAMPLE 1
+#endif
+
+#define DAC_SILENCE 128  // Mid-scale, no click when a clip ends
+#define DMA_TIMEOUT 100  // Max wait for a DMA buffer before giving up (ms)
+
+FastAudio::FastAudio()
+{
+    pack = NULL;
+    clips = NULL;
+    clipCount = 0;
+    volume = 0;
+    dac = NULL;
+    events = NULL;
+    task = NULL;
+    lock = portMUX_INITIALIZER_UNLOCKED;
+    request = NULL;
+    requestUs = 0;
+    running = false;
+    playing = false;
+    stats.plays = 0;
+    stats.underruns = 0;
+    stats.maxStartLatencyUs = 0;
+}
+
+/**
+ * @brief Map the audio partition and prepare the DAC
+ *
+ * The DAC clock comes from the APLL: the I2S clock cannot go below ~20kHz on
+ * ESP32, the clips are packed at a lower rate to save flash.
+ *
+ * @return true if clips were found and the DAC is ready
+ */
+bool FastAudio::begin(dac_channel_t dacChannel, uint8_t volume)
+{
+    this->volume = volume > 30 ? 30 : volume;
+
+    const esp_partition_t *partition = esp_partition_find_first(
+        ESP_PARTITION_TYPE_DATA, (esp_partition_subtype_t)FAST_AUDIO_PARTITION_SUBTYPE, FAST_AUDIO_PARTITION);
+    if (partition == NULL)
+    {
+        return false;
+    }
+
+    const void *mapped = NULL;
+    esp_partition_mmap_handle_t mapping;
+    if (esp_partition_mmap(partition, 0, partition->size, ESP_PARTITION_MMAP_DATA, &mapped, &mapping) != ESP_OK)
+    {
+        return false;
+    }
+
+    // Reject an erased partition or a pack that does not fit
+    const AudioPackHeader *header = (const AudioPackHeader *)mapped;
+    bool valid = header->magic == AUDIO_PACK_MAGIC && header->version == AUDIO_PACK_VERSION &&
+                 header->clipCount > 0 && header->sampleRate > 0 &&
+                 sizeof(AudioPackHeader) + header->clipCount * sizeof(AudioPackClip) <= partition->size;
+    const AudioPackClip *table = (const AudioPackClip *)(header + 1);
+    for (uint16_t i = 0; valid && i < header->clipCount; i++)
+    {
+        const AudioPackClip &clip = table[i];
+        uint32_t samplesPerBlock = imaAdpcmSamplesPerBlock(clip.blockSize);
+        uint32_t blocks = (clip.samples + samplesPerBlock - 1) / samplesPerBlock;
+        valid = clip.blockSize > IMA_ADPCM_BLOCK_HEADER &&
+                clip.offset <= partition->size &&
+                blocks * clip.blockSize <= partition->size - clip.offset;
+    }
+    if (!valid)
+    {
+        esp_partition_munmap(mapping);
+        return false;
+    }
+
+    dac_continuous_config_t config = {
+        .chan_mask = (dac_channel_mask_t)BIT(dacChannel),
+        .desc_num = FAST_AUDIO_DMA_BUFFERS,
+        .buf_size = FAST_AUDIO_BUFFER_SAMPLES * DAC_BYTES_PER_SAMPLE,
+        .freq_hz = header->sampleRate,
+        .offset = 0,
+        .clk_src = DAC_DIGI_CLK_SRC_APLL,
+        .chan_mode = DAC_CHANNEL_MODE_SIMUL,
+    };
+    if (dac_continuous_new_channels(&config, &dac) != ESP_OK)
+    {
+        esp_partition_munmap(mapping);
+        return false;
+    }
+
+    events = xQueueCreate(FAST_AUDIO_DMA_BUFFERS, sizeof(dac_event_data_t));
+    dac_event_callbacks_t callbacks = {
+        .on_convert_done = &FastAudio::onConvertDone,
+        .on_stop = NULL,
+    };
+    if (events == NULL || dac_continuous_register_event_callback(dac, &callbacks, this) != ESP_OK ||
+        xTaskCreatePinnedToCore(&FastAudio::taskEntry, "audio", TASK_STACK, this, TASK_PRIORITY, &task, 0) != pdPASS)
+    {
+        dac_continuous_del_channels(dac);
+        esp_partition_munmap(mapping);
+        return false;
+    }
+
+    pack = (const uint8_t *)mapped;
+    clips = table;
+    clipCount = header->clipCount;
+    return true;
+}
+
+/**
+ * @brief Check if a track is packed in flash
+ */
+bool FastAudio::hasClip(uint8_t folder, uint8_t track)
+{
+    return findClip(folder, track) != NULL;
+}
+
+/**
+ * @brief Start a clip, cuts the one in progress if any
+ *
+ * Only hands the clip over to the task, which starts the DMA or switches to
+ * the new clip at the next buffer.
+ *
+ * @return false if the track is not packed in flash
+ */
+bool FastAudio::play(uint8_t folder, uint8_t track)
+{
+    const AudioPackClip *clip = findClip(folder, track);
+    if (clip == NULL)
+    {
+        return false;
+    }
+
+    taskENTER_CRITICAL(&lock);
+    request = clip;
+    requestUs = micros();
+    playing = true;
+    bool wake = !running;
+    running = true;
+    taskEXIT_CRITICAL(&lock);
+
+    if (wake)
+    {
+        xTaskNotifyGive(task);
+    }
+    stats.plays++;
+    return true;
+}
+
+/**
+ * @brief Check if a clip is playing
+ */
+bool FastAudio::isPlaying()
+{
+    return playing;
+}
+
+/**
+ * @brief Get the fast path counters
+ */
+FastAudioStats FastAudio::getStats()
+{
+    return stats;
+}
+
+/**
+ * @brief Find a clip in the pack table
+ *
+ * @return The clip, or NULL if not packed (or no pack)
+ */
+const AudioPackClip *FastAudio::findClip(uint8_t folder, uint8_t track)
+{
+    for (uint16_t i = 0; i < clipCount; i++)
+    {
+        if (clips[i].folder == folder && clips[i].track == track)
+        {
+            return &clips[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Audio task: feeds the DMA buffers while clips are playing
+ *
+ * Sleeps until play() wakes it up, then starts the DMA and fills each buffer
+ * the DAC gives back. Once the clip is over, silence is sent until the last
+ * samples are out and the DMA is stopped until the next clip.
+ */
+void FastAudio::run()
+{
+    ImaAdpcmDecoder decoder;
+    int16_t pcm[FAST_AUDIO_BUFFER_SAMPLES];
+    uint8_t samples[FAST_AUDIO_BUFFER_SAMPLES];
+    // Volume in Q8, 30 is full scale like on the DFPlayer
+    int32_t gain = (volume * 256) / 30;
+    bool restart = false;
+
+    while (true)
+    {
+        if (!restart)
+        {
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        }
+        xQueueReset(events);
+        dac_continuous_enable(dac);
+        dac_continuous_start_async_writing(dac);
+
+        uint8_t silentBuffers = 0;
+        bool starting = false;
+        uint32_t startUs = 0;
+        dac_event_data_t event;
+        while (silentBuffers < FAST_AUDIO_DMA_BUFFERS &&
+               xQueueReceive(events, &event, pdMS_TO_TICKS(DMA_TIMEOUT)) == pdTRUE)
+        {
+            taskENTER_CRITICAL(&lock);
+            const AudioPackClip *clip = request;
+            request = NULL;
+            if (clip != NULL)
+            {
+                startUs = requestUs;
+            }
+            taskEXIT_CRITICAL(&lock);
+
+            if (clip != NULL)
+            {
+                decoder.begin(pack + clip->offset, clip->samples, clip->blockSize);
+                starting = true;
+                silentBuffers = 0;
+            }
+
+            size_t count = decoder.read(pcm, FAST_AUDIO_BUFFER_SAMPLES);
+            for (size_t i = 0; i < count; i++)
+            {
+                samples[i] = (uint8_t)(DAC_SILENCE + ((pcm[i] * gain) >> 16));
+            }
+            memset(samples + count, DAC_SILENCE, FAST_AUDIO_BUFFER_SAMPLES - count);
+
+            if (count == 0)
+            {
+                silentBuffers++;
+            }
+            else if (starting)
+            {
+                uint32_t latency = micros() - startUs;
+                if (latency > stats.maxStartLatencyUs)
+                {
+                    stats.maxStartLatencyUs = latency;
+                }
+                starting = false;
+            }
+
+            size_t loaded = 0;
+            dac_continuous_write_asynchronously(dac, (uint8_t *)event.buf, event.buf_size,
+                                                samples, FAST_AUDIO_BUFFER_SAMPLES, &loaded);
+        }
+
+        dac_continuous_stop_async_writing(dac);
+        dac_continuous_disable(dac);
+
+        // A clip requested while stopping starts right away
+        taskENTER_CRITICAL(&lock);
+        restart = request != NULL;
+        if (!restart)
+        {
+            running = false;
+            playing = false;
+        }
+        taskEXIT_CRITICAL(&lock);
+    }
+}
+
+/**
+ * @brief Task entry point
+ */
+void FastAudio::taskEntry(void *arg)
+{
+    static_cast<FastAudio *>(arg)->run();
+}
+
+/**
+ * @brief DMA buffer done callback (ISR context), hands the buffer to the task
+ *
+ * When the task did not take the previous buffers in time, the oldest one is
+ * dropped (it is played again) and counted as an underrun.
+ */
+bool IRAM_ATTR FastAudio::onConvertDone(dac_continuous_handle_t handle, const dac_event_data_t *event, void *userData)
+{
+    FastAudio *self = static_cast<FastAudio *>(userData);
+    BaseType_t woken = pdFALSE;
+    if (xQueueIsQueueFullFromISR(self->events))
+    {
+        dac_event_data_t dropped;
+        xQueueReceiveFromISR(self->events, &dropped, &woken);
+        self->stats.underruns++;
+    }
+    xQueueSendFromISR(self->events, event, &woken);
+    return woken == pdTRUE;
+}
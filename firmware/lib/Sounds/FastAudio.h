@@ -0,0 +1,104 @@
+#ifndef FAST_AUDIO_H
+#define FAST_AUDIO_H
+
+#include <Arduino.h>
+#include <esp_partition.h>
+#include <driver/dac_continuous.h>
+#include "AudioPack.h"
+#include "ImaAdpcm.h"
+
+// Data partition holding the clips (see partitions.csv)
+#define FAST_AUDIO_PARTITION "audio"
+#define FAST_AUDIO_PARTITION_SUBTYPE 0x40
+
+// DMA buffers: 2 x 64 samples, 4ms each at 16kHz. Silence is queued while
+// the DMA starts, so the first samples come out 2 buffers later at most
+#define FAST_AUDIO_DMA_BUFFERS 2
+#define FAST_AUDIO_BUFFER_SAMPLES 64
+
+/**
+ * @brief Fast path counters
+ */
+typedef struct
+{
+    uint32_t plays;             // Clips started
+    uint32_t underruns;         // DMA buffers the decoder was too late for
+    uint32_t maxStartLatencyUs; // Worst time from play() to the first samples queued to the DMA
+} FastAudioStats;
+
+/**
+ * @brief FastAudio class, plays IMA-ADPCM clips from flash on the ESP32 DAC
+ *
+ * The clips are packed into a data partition by tools/audio_pack.py and
+ * memory-mapped, nothing is copied to RAM. A task decodes them one DMA
+ * buffer at a time and the DAC continuous driver sends the buffers to the
+ * DAC through I2S0 with DMA. The DMA only runs while a clip plays.
+ *
+ * I2S0 is also the ADC DMA on ESP32: do not use ADC continuous mode with it.
+ */
+class FastAudio
+{
+public:
+    FastAudio();
+
+    /**
+     * @brief Map the audio partition and prepare the DAC
+     *
+     * @param dacChannel DAC_CHAN_0 (GPIO 25) or DAC_CHAN_1 (GPIO 26)
+     * @param volume Volume level (0-30, same scale as the DFPlayer)
+     *
+     * @return true if clips were found and the DAC is ready
+     */
+    bool begin(dac_channel_t dacChannel, uint8_t volume);
+
+    /**
+     * @brief Check if a track is packed in flash
+     */
+    bool hasClip(uint8_t folder, uint8_t track);
+
+    /**
+     * @brief Start a clip, cuts the one in progress if any
+     *
+     * @return false if the track is not packed in flash
+     */
+    bool play(uint8_t folder, uint8_t track);
+
+    /**
+     * @brief Check if a clip is playing
+     */
+    bool isPlaying();
+
+    /**
+     * @brief Get the fast path counters
+     */
+    FastAudioStats getStats();
+
+private:
+    const uint8_t *pack; // Mapped partition
+    const AudioPackClip *clips;
+    uint16_t clipCount;
+    uint8_t volume;
+
+    dac_continuous_handle_t dac;
+    QueueHandle_t events;  // DMA buffers to fill, from the DAC ISR
+    TaskHandle_t task;
+    portMUX_TYPE lock;
+
+    // Shared with the task, under lock
+    const AudioPackClip *request; // Clip to start at the next buffer
+    uint32_t requestUs;           // micros() when it was requested
+    bool running;                 // The task is feeding the DMA
+    volatile bool playing;
+
+    FastAudioStats stats;
+
+    static const uint32_t TASK_STACK = 3072;
+    static const UBaseType_t TASK_PRIORITY = 10; // Above loop(), must answer within one buffer
+
+    const AudioPackClip *findClip(uint8_t folder, uint8_t track);
+    void run();
+    static void taskEntry(void *arg);
+    static bool onConvertDone(dac_continuous_handle_t handle, const dac_event_data_t *event, void *userData);
+};
+
+#endif // FAST_AUDIO_H
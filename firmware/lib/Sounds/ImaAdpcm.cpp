@@ -0,0 +1,129 @@
+#include "ImaAdpcm.h"
+
+static const int8_t INDEX_TABLE[16] = {
+    -1, -1, -1, -1, 2, 4, 6, 8,
+    -1, -1, -1, -1, 2, 4, 6, 8};
+
+static const int16_t STEP_TABLE[89] = {
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17,
+    19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+    50, 55, 60, 66, 73, 80, 88, 97, 107, 118,
+    130, 143, 157, 173, 190, 209, 230, 253, 279, 307,
+    337, 371, 408, 449, 494, 544, 598, 658, 724, 796,
+    876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066,
+    2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428, 4871, 5358,
+    5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899,
+    15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767};
+
+ImaAdpcmDecoder::ImaAdpcmDecoder()
+{
+    block = NULL;
+    remainingSamples = 0;
+    blockSize = 0;
+    position = 0;
+    highNibble = false;
+    predictor = 0;
+    index = 0;
+}
+
+/**
+ * @brief Start decoding a clip
+ */
+void ImaAdpcmDecoder::begin(const uint8_t *data, uint32_t samples, uint16_t blockSize)
+{
+    block = data;
+    remainingSamples = (blockSize > IMA_ADPCM_BLOCK_HEADER) ? samples : 0;
+    this->blockSize = blockSize;
+    position = 0;
+    highNibble = false;
+}
+
+/**
+ * @brief Decode the next samples
+ *
+ * @return Samples decoded, less than count at the end of the clip
+ */
+size_t ImaAdpcmDecoder::read(int16_t *out, size_t count)
+{
+    size_t decoded = 0;
+
+    while (decoded < count && remainingSamples > 0)
+    {
+        if (position == 0)
+        {
+            // Block header: the first sample is stored as is
+            predictor = (int16_t)(block[0] | (block[1] << 8));
+            index = block[2] > 88 ? 88 : block[2];
+            position = IMA_ADPCM_BLOCK_HEADER;
+            highNibble = false;
+            out[decoded++] = (int16_t)predictor;
+        }
+        else
+        {
+            uint8_t byte = block[position];
+            uint8_t code = highNibble ? byte >> 4 : byte & 0x0F;
+            out[decoded++] = decode(code);
+            if (highNibble)
+            {
+                position++;
+                if (position >= blockSize)
+                {
+                    block += blockSize;
+                    position = 0;
+                }
+            }
+            highNibble = !highNibble;
+        }
+        remainingSamples--;
+    }
+    return decoded;
+}
+
+/**
+ * @brief Samples left to decode
+ */
+uint32_t ImaAdpcmDecoder::remaining()
+{
+    return remainingSamples;
+}
+
+/**
+ * @brief Decode one 4-bit code (reference IMA algorithm)
+ */
+int16_t ImaAdpcmDecoder::decode(uint8_t code)
+{
+    int32_t step = STEP_TABLE[index];
+    int32_t diff = step >> 3;
+    if (code & 4)
+    {
+        diff += step;
+    }
+    if (code & 2)
+    {
+        diff += step >> 1;
+    }
+    if (code & 1)
+    {
+        diff += step >> 2;
+    }
+    predictor += (code & 8) ? -diff : diff;
+    if (predictor > 32767)
+    {
+        predictor = 32767;
+    }
+    else if (predictor < -32768)
+    {
+        predictor = -32768;
+    }
+
+    index += INDEX_TABLE[code];
+    if (index < 0)
+    {
+        index = 0;
+    }
+    else if (index > 88)
+    {
+        index = 88;
+    }
+    return (int16_t)predictor;
+}
@@ -0,0 +1,70 @@
+#ifndef IMA_ADPCM_H
+#define IMA_ADPCM_H
+
+// Pure C++ (no Arduino dependency) so it can be tested on the host
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Bytes of the header of each block: first sample (int16), step index, 0
+#define IMA_ADPCM_BLOCK_HEADER 4
+
+/**
+ * @brief Samples in a block of blockSize bytes (mono)
+ *
+ * The header holds the first sample, then each byte holds two samples.
+ */
+inline uint32_t imaAdpcmSamplesPerBlock(uint16_t blockSize)
+{
+    return (uint32_t)(blockSize - IMA_ADPCM_BLOCK_HEADER) * 2 + 1;
+}
+
+/**
+ * @brief Streaming IMA-ADPCM decoder, mono, blocked like in WAV files
+ *
+ * Each block starts with a header (first sample and step index, so that a
+ * block can be decoded on its own), then 4-bit codes, low nibble first.
+ * Samples are decoded on demand, any number at a time: no block buffer.
+ */
+class ImaAdpcmDecoder
+{
+public:
+    ImaAdpcmDecoder();
+
+    /**
+     * @brief Start decoding a clip
+     *
+     * @param data Encoded blocks, must stay valid while decoding
+     * @param samples Number of samples of the clip (the last block is padded)
+     * @param blockSize Size of a block (bytes)
+     */
+    void begin(const uint8_t *data, uint32_t samples, uint16_t blockSize);
+
+    /**
+     * @brief Decode the next samples
+     *
+     * @param out Output buffer
+     * @param count Samples wanted
+     *
+     * @return Samples decoded, less than count at the end of the clip
+     */
+    size_t read(int16_t *out, size_t count);
+
+    /**
+     * @brief Samples left to decode
+     */
+    uint32_t remaining();
+
+private:
+    const uint8_t *block;   // Current block
+    uint32_t remainingSamples;
+    uint16_t blockSize;
+    uint16_t position;      // Byte of the current block, 0 before its header
+    bool highNibble;        // Next code is the high nibble of the current byte
+    int32_t predictor;
+    int8_t index;
+
+    int16_t decode(uint8_t code);
+};
+
+#endif // IMA_ADPCM_H
@@ -1,58 +1,408 @@
 #include "Sounds.h"
+#include <esp_sleep.h>
+#include <driver/gpio.h>
+#include <driver/uart.h>
 
-Sounds::Sounds(int8_t rxPin, int8_t txPin): serial(2), dfPlayer()
+// RX edges needed to wake up, the bytes carrying them are lost
+#define UART_WAKEUP_THRESHOLD 3
+
+#define DFPLAYER_BOOT_TIMEOUT 3000  // Max time for the DFPlayer to boot after a reset (ms)
+#define DFPLAYER_REPLY_TIMEOUT 200  // Max time to answer a status query (ms)
+#define DFPLAYER_COMMAND_GAP 30     // Min time between two commands (ms)
+#define DFPLAYER_PROBE_INTERVAL 2000 // Time between two status queries when online (ms)
+#define DFPLAYER_RETRY_INTERVAL 5000 // Time between two reconnection attempts (ms)
+#define DFPLAYER_MAX_MISSED_REPLIES 3 // Unanswered queries before declaring the DFPlayer lost
+
+Sounds::Sounds(int8_t rxPin, int8_t txPin, uint8_t uartNum): serial(uartNum), parser(), fastAudio()
 {
     // Initialize DFPlayer Mini
     this->rxPin = rxPin;
     this->txPin = txPin;
+    this->uartNum = uartNum;
+    dfPlayerAvailable = false;
+    fastAudioAvailable = false;
+    wasOnline = false;
+    playing = false;
+    replyPending = false;
+    missedReplies = 0;
+    playPending = false;
+    state = LINK_BACKOFF;
+    stateTime = 0;
+    lastTxTime = 0;
+    lastProbeTime = 0;
+    unavailableSince = 0;
+    stats.disconnects = 0;
+    stats.recoveries = 0;
+    stats.unavailableMs = 0;
+    stats.timeouts = 0;
+    stats.errorFrames = 0;
 }
 
 void Sounds::begin(const SoundsConfig &config)
 {
     this->config = config;
+    if (config.fastAudioDac >= 0)
+    {
+        fastAudioAvailable = fastAudio.begin((dac_channel_t)config.fastAudioDac, config.volume);
+    }
     serial.begin(9600, SERIAL_8N1, rxPin, txPin);
-    delay(1000);  // Give DFPlayer time to initialize
-    if (dfPlayer.begin(serial)) {
-        dfPlayer.setTimeOut(500); // Set serial timeout to 500ms
-        dfPlayer.EQ(DFPLAYER_EQ_NORMAL);
-        dfPlayer.volume(config.volume);      // Set volume to a reasonable level
-        dfPlayerAvailable = true;
-    } else {
-        dfPlayerAvailable = false;
+    unavailableSince = millis();
+    // The DFPlayer takes up to a few seconds to boot: update() carries on
+    // with the initialization instead of waiting here
+    startReset(unavailableSince);
+}
+
+void Sounds::update()
+{
+  unsigned long now = millis();
+
+  while (serial.available())
+  {
+    if (parser.push(serial.read()))
+    {
+      handleFrame(parser.frame(), now);
+    }
+  }
+
+  switch (state)
+  {
+  case LINK_RESETTING:
+    // Clones do not always announce themselves, probe anyway after a while
+    if (now - stateTime >= DFPLAYER_BOOT_TIMEOUT)
+    {
+      startProbe(now);
+    }
+    break;
+
+  case LINK_PROBING:
+    if (!replyPending)
+    {
+      if (canSend(now))
+      {
+        send(DFPLAYER_CMD_QUERY_STATUS, 0, now);
+        replyPending = true;
+        lastProbeTime = now;
+      }
+    }
+    else if (now - lastProbeTime >= DFPLAYER_REPLY_TIMEOUT)
+    {
+      replyPending = false;
+      stats.timeouts++;
+      enterState(LINK_BACKOFF, now);
+    }
+    break;
+
+  case LINK_CONFIG_EQ:
+    if (canSend(now))
+    {
+      send(DFPLAYER_CMD_EQ, DFPLAYER_EQ_NORMAL, now);
+      enterState(LINK_CONFIG_VOLUME, now);
+    }
+    break;
+
+  case LINK_CONFIG_VOLUME:
+    if (canSend(now))
+    {
+      send(DFPLAYER_CMD_VOLUME, config.volume, now);
+      setOnline(now);
+    }
+    break;
+
+  case LINK_ONLINE:
+    if (replyPending)
+    {
+      if (now - lastProbeTime >= DFPLAYER_REPLY_TIMEOUT)
+      {
+        replyPending = false;
+        stats.timeouts++;
+        if (++missedReplies >= DFPLAYER_MAX_MISSED_REPLIES)
+        {
+          setOffline(now);
+          enterState(LINK_BACKOFF, now);
+        }
+      }
+    }
+    else if (playPending)
+    {
+      if (canSend(now))
+      {
+        send(DFPLAYER_CMD_PLAY_FOLDER, ((uint16_t)pendingFolder << 8) | pendingTrack, now);
+        playPending = false;
+      }
+    }
+    else if (now - lastProbeTime >= DFPLAYER_PROBE_INTERVAL && canSend(now))
+    {
+      send(DFPLAYER_CMD_QUERY_STATUS, 0, now);
+      replyPending = true;
+      lastProbeTime = now;
+    }
+    break;
+
+  case LINK_BACKOFF:
+    if (now - stateTime >= DFPLAYER_RETRY_INTERVAL)
+    {
+      startReset(now);
     }
+    break;
+  }
 }
 
-bool Sounds::playYawningSound()
+void Sounds::handleFrame(const DFPlayerFrame &frame, unsigned long now)
+{
+  switch (frame.command)
+  {
+  case DFPLAYER_MSG_STATUS:
+    replyPending = false;
+    missedReplies = 0;
+    playing = (frame.parameter & 0xFF) == 1;
+    if (state == LINK_PROBING)
+    {
+      enterState(LINK_CONFIG_EQ, now);
+    }
+    break;
+
+  case DFPLAYER_MSG_ONLINE:
+  case DFPLAYER_MSG_CARD_INSERTED:
+    // Either the answer to our reset, or the module rebooted by itself
+    // (brown-out) or got its card back: in all cases it lost its settings
+    setOffline(now);
+    startProbe(now);
+    break;
+
+  case DFPLAYER_MSG_CARD_REMOVED:
+    setOffline(now);
+    enterState(LINK_BACKOFF, now);
+    break;
+
+  case DFPLAYER_MSG_TRACK_FINISHED:
+    playing = false;
+    break;
+
+  case DFPLAYER_MSG_ERROR:
+    stats.errorFrames++;
+    if (frame.parameter == DFPLAYER_ERROR_BUSY)
+    {
+      // Module is initializing after an unexpected reboot, wait for it
+      setOffline(now);
+      enterState(LINK_RESETTING, now);
+    }
+    else if (replyPending)
+    {
+      // Error answer to our query, but the module is alive
+      replyPending = false;
+      missedReplies = 0;
+    }
+    break;
+
+  default:
+    break; // ACK and other feedback not used
+  }
+}
+
+void Sounds::send(uint8_t command, uint16_t parameter, unsigned long now)
+{
+  uint8_t frame[DFPLAYER_FRAME_SIZE];
+  dfPlayerEncode(command, parameter, false, frame);
+  // 10 bytes always fit in the UART hardware FIFO: does not block
+  serial.write(frame, DFPLAYER_FRAME_SIZE);
+  lastTxTime = now;
+}
+
+bool Sounds::canSend(unsigned long now)
+{
+  return now - lastTxTime >= DFPLAYER_COMMAND_GAP;
+}
+
+void Sounds::enterState(SoundsLinkState newState, unsigned long now)
+{
+  state = newState;
+  stateTime = now;
+}
+
+void Sounds::startReset(unsigned long now)
+{
+  replyPending = false;
+  parser.reset();
+  send(DFPLAYER_CMD_RESET, 0, now);
+  enterState(LINK_RESETTING, now);
+}
+
+void Sounds::startProbe(unsigned long now)
+{
+  replyPending = false;
+  enterState(LINK_PROBING, now);
+}
+
+void Sounds::setOnline(unsigned long now)
+{
+  dfPlayerAvailable = true;
+  if (wasOnline)
+  {
+    stats.recoveries++;
+  }
+  wasOnline = true;
+  stats.unavailableMs += now - unavailableSince;
+  missedReplies = 0;
+  lastProbeTime = now;
+  enterState(LINK_ONLINE, now);
+}
+
+void Sounds::setOffline(unsigned long now)
+{
+  if (dfPlayerAvailable)
+  {
+    dfPlayerAvailable = false;
+    stats.disconnects++;
+    unavailableSince = now;
+  }
+  playing = false;
+  playPending = false;
+}
+
+bool Sounds::isAvailable()
+{
+  return dfPlayerAvailable;
+}
+
+bool Sounds::isFastAudioAvailable()
+{
+  return fastAudioAvailable;
+}
+
+bool Sounds::isPlaying()
 {
-  if (dfPlayerAvailable && (dfPlayer.readState() != 1))
+  return playing || fastAudio.isPlaying();
+}
+
+SoundsStats Sounds::getStats()
+{
+  SoundsStats current = stats;
+  if (!dfPlayerAvailable)
+  {
+    current.unavailableMs += millis() - unavailableSince;
+  }
+  current.fastAudio = fastAudio.getStats();
+  return current;
+}
+
+bool Sounds::play(uint8_t folder, uint8_t track)
+{
+  if (isPlaying() || playPending)
+  {
+    return false;
+  }
+
+  // Starts within a few ms, not after the DFPlayer has read its SD card
+  if (fastAudio.play(folder, track))
   {
-    uint8_t soundIndex = random(1, config.yawningNbSounds + 1);
-    dfPlayer.playFolder(config.yawningFolder, soundIndex);
     return true;
   }
-  return false;
+
+  if (!dfPlayerAvailable)
+  {
+    return false;
+  }
+
+  unsigned long now = millis();
+  if (!replyPending && canSend(now))
+  {
+    send(DFPLAYER_CMD_PLAY_FOLDER, ((uint16_t)folder << 8) | track, now);
+  }
+  else
+  {
+    // Sent by update() once the DFPlayer can take it
+    pendingFolder = folder;
+    pendingTrack = track;
+    playPending = true;
+  }
+  playing = true; // Until the next status reply says otherwise
+  return true;
+}
+
+bool Sounds::playYawningSound()
+{
+  uint8_t soundIndex = random(1, config.yawningNbSounds + 1);
+  return play(config.yawningFolder, soundIndex);
 }
 
 bool Sounds::playSpeechOrEffectSound()
 {
-  if (dfPlayerAvailable && (dfPlayer.readState() != 1))
+  uint8_t speechoreffect = random(0, 2);
+  uint8_t folderNumber;
+  uint8_t nbSounds;
+  if (speechoreffect == 0 || config.speechNbSounds == 0)
+  {
+    folderNumber = config.speechFolder;
+    nbSounds = config.speechNbSounds;
+  }
+  else
   {
-    uint8_t speechoreffect = random(0, 2);
-    uint8_t folderNumber;
-    uint8_t nbSounds;
-    if (speechoreffect == 0 || config.speechNbSounds == 0)
+    folderNumber = config.effectFolder;
+    nbSounds = config.effectNbSounds;
+  }
+  uint8_t soundIndex = random(1, nbSounds + 1);
+  return play(folderNumber, soundIndex);
+}
+
+bool Sounds::playTrack(uint8_t folder, uint8_t track)
+{
+  if (track == 0)
+  {
+    uint8_t nbSounds = 0;
+    if (folder == config.yawningFolder)
+    {
+      nbSounds = config.yawningNbSounds;
+    }
+    else if (folder == config.speechFolder)
     {
-      folderNumber = config.speechFolder;
       nbSounds = config.speechNbSounds;
     }
-    else
+    else if (folder == config.effectFolder)
     {
-      folderNumber = config.effectFolder;
       nbSounds = config.effectNbSounds;
     }
-    uint8_t soundIndex = random(1, nbSounds + 1);
-    dfPlayer.playFolder(folderNumber, soundIndex);
-    return true;
+    if (nbSounds == 0)
+    {
+      return false;
+    }
+    track = random(1, nbSounds + 1);
   }
-  return false;
-}
\ No newline at end of file
+  return play(folder, track);
+}
+
+bool Sounds::canSleep()
+{
+  // A reply arriving during light sleep loses its first bytes, and the
+  // DAC DMA stops while sleeping
+  return !replyPending && !playPending && !fastAudio.isPlaying() &&
+         (state == LINK_ONLINE || state == LINK_BACKOFF);
+}
+
+void Sounds::prepareSleep()
+{
+  // The UART clock stops in light sleep: make sure the last command is
+  // fully shifted out, otherwise the DFPlayer receives a corrupted frame
+  serial.flush();
+  // Keep TX idle (high) so the DFPlayer does not see a start bit
+  gpio_hold_en((gpio_num_t)txPin);
+
+  if (uartNum <= 1)
+  {
+    // Wake up when the DFPlayer starts talking (e.g. track finished)
+    uart_set_wakeup_threshold((uart_port_t)uartNum, UART_WAKEUP_THRESHOLD);
+    esp_sleep_enable_uart_wakeup(uartNum);
+  }
+}
+
+void Sounds::resumeFromSleep()
+{
+  gpio_hold_dis((gpio_num_t)txPin);
+
+  if (esp_sleep_get_wakeup_cause() == ESP_SLEEP_WAKEUP_UART)
+  {
+    // The first bytes of the frame that woke us up were consumed by the
+    // wakeup logic: drop what was parsed so far, the parser re-synchronizes
+    // on the next start marker
+    parser.reset();
+  }
+}
@@ -1,8 +1,9 @@
 #ifndef SOUNDS_H
 #define SOUNDS_H
 
-#include <DFRobotDFPlayerMini.h>
 #include <HardwareSerial.h>
+#include "DFPlayerProtocol.h"
+#include "FastAudio.h"
 
 // Structure for folder configuration
 typedef struct
@@ -14,25 +15,99 @@ typedef struct
     uint8_t yawningNbSounds; // Number of yawning sound files
     uint8_t speechNbSounds;  // Number of speech sound files
     uint8_t effectNbSounds;  // Number of effect sound files
+    int8_t fastAudioDac;     // DAC for the clips packed in flash (0: GPIO 25, 1: GPIO 26), -1 for the DFPlayer only
 } SoundsConfig;
 
+// DFPlayer health counters
+typedef struct
+{
+    uint32_t disconnects;   // Times the DFPlayer was lost after being online
+    uint32_t recoveries;    // Times it came back online after a disconnect
+    uint32_t unavailableMs; // Total time without a usable DFPlayer since begin()
+    uint32_t timeouts;      // Status queries left unanswered
+    uint32_t errorFrames;   // Error messages received from the DFPlayer
+    FastAudioStats fastAudio; // Clips played from flash
+} SoundsStats;
+
+// DFPlayer link state machine
+enum SoundsLinkState
+{
+    LINK_RESETTING,      // Reset sent, waiting for the module to boot
+    LINK_PROBING,        // Status query sent, waiting for a reply
+    LINK_CONFIG_EQ,      // Module answered, restoring EQ
+    LINK_CONFIG_VOLUME,  // Restoring volume
+    LINK_ONLINE,         // Ready to play, status polled periodically
+    LINK_BACKOFF,        // Module missing, waiting before the next reset
+};
+
 class Sounds
 {
 public:
-    Sounds(int8_t rxPin, int8_t txPin);
+    // uartNum: only UART0/UART1 can wake the ESP32 from light sleep
+    Sounds(int8_t rxPin, int8_t txPin, uint8_t uartNum = 2);
 
+    // Starts the DFPlayer initialization, does not wait for it
     void begin(const SoundsConfig &config);
 
+    // Runs the DFPlayer link: parses its messages, initializes it, monitors
+    // its health and reconnects it. Never blocks, call this in loop()
+    void update();
+
     bool playYawningSound();
     bool playSpeechOrEffectSound();
+    // track 0 picks a random track when folder is one of the configured ones
+    bool playTrack(uint8_t folder, uint8_t track);
+
+    bool isAvailable();
+    bool isFastAudioAvailable();
+    bool isPlaying();
+    SoundsStats getStats();
+
+    // Light sleep support: only sleep when canSleep() (no reply expected),
+    // call prepareSleep() right before esp_light_sleep_start() and
+    // resumeFromSleep() right after it
+    bool canSleep();
+    void prepareSleep();
+    void resumeFromSleep();
 
 private:
     HardwareSerial serial;
-    DFRobotDFPlayerMini dfPlayer;
-    bool dfPlayerAvailable;
+    DFPlayerParser parser;
     int8_t rxPin;
     int8_t txPin;
+    uint8_t uartNum;
     SoundsConfig config;
+    FastAudio fastAudio;
+    bool fastAudioAvailable;
+
+    SoundsLinkState state;
+    unsigned long stateTime;     // When the current state was entered
+    unsigned long lastTxTime;    // When the last command was sent
+    unsigned long lastProbeTime; // When the last status query was sent
+    bool replyPending;           // A status reply is expected
+    uint8_t missedReplies;       // Consecutive unanswered status queries
+
+    bool dfPlayerAvailable;
+    bool wasOnline;
+    bool playing;
+    unsigned long unavailableSince;
+    SoundsStats stats;
+
+    // Play request waiting for the inter-command gap
+    bool playPending;
+    uint8_t pendingFolder;
+    uint8_t pendingTrack;
+
+    // Clips packed in flash play on the DAC, the others on the DFPlayer
+    bool play(uint8_t folder, uint8_t track);
+    void send(uint8_t command, uint16_t parameter, unsigned long now);
+    bool canSend(unsigned long now);
+    void handleFrame(const DFPlayerFrame &frame, unsigned long now);
+    void enterState(SoundsLinkState newState, unsigned long now);
+    void startReset(unsigned long now);
+    void startProbe(unsigned long now);
+    void setOnline(unsigned long now);
+    void setOffline(unsigned long now);
 };
 
 #endif // SOUNDS_H
@@ -0,0 +1,296 @@
+#include "TextScroller.h"
+
+#define FONT_FIRST ' '
+#define FONT_LAST '_'
+#define FONT_WIDTH 5
+
+/**
+ * @brief 5x7 font, ' ' to '_'
+ *
+ * One byte per column, left to right, bit 0 is the top row. Kept in flash
+ * (320 bytes).
+ */
+static const uint8_t FONT[FONT_LAST - FONT_FIRST + 1][FONT_WIDTH] = {
+    {0x00, 0x00, 0x00, 0x00, 0x00}, // ' '
+    {0x00, 0x00, 0x5F, 0x00, 0x00}, // '!'
+    {0x00, 0x07, 0x00, 0x07, 0x00}, // '"'
+    {0x14, 0x7F, 0x14, 0x7F, 0x14}, // '#'
+    {0x24, 0x2A, 0x7F, 0x2A, 0x12}, // '$'
+    {0x23, 0x13, 0x08, 0x64, 0x62}, // '%'
+    {0x36, 0x49, 0x56, 0x20, 0x50}, // '&'
+    {0x00, 0x05, 0x03, 0x00, 0x00}, // '''
+    {0x00, 0x1C, 0x22, 0x41, 0x00}, // '('
+    {0x00, 0x41, 0x22, 0x1C, 0x00}, // ')'
+    {0x14, 0x08, 0x3E, 0x08, 0x14}, // '*'
+    {0x08, 0x08, 0x3E, 0x08, 0x08}, // '+'
+    {0x00, 0x50, 0x30, 0x00, 0x00}, // ','
+    {0x08, 0x08, 0x08, 0x08, 0x08}, // '-'
+    {0x00, 0x60, 0x60, 0x00, 0x00}, // '.'
+    {0x20, 0x10, 0x08, 0x04, 0x02}, // '/'
+    {0x3E, 0x51, 0x49, 0x45, 0x3E}, // '0'
+    {0x00, 0x42, 0x7F, 0x40, 0x00}, // '1'
+    {0x42, 0x61, 0x51, 0x49, 0x46}, // '2'
+    {0x21, 0x41, 0x45, 0x4B, 0x31}, // '3'
+    {0x18, 0x14, 0x12, 0x7F, 0x10}, // '4'
+    {0x27, 0x45, 0x45, 0x45, 0x39}, // '5'
+    {0x3C, 0x4A, 0x49, 0x49, 0x30}, // '6'
+    {0x01, 0x71, 0x09, 0x05, 0x03}, // '7'
+    {0x36, 0x49, 0x49, 0x49, 0x36}, // '8'
+    {0x06, 0x49, 0x49, 0x29, 0x1E}, // '9'
+    {0x00, 0x36, 0x36, 0x00, 0x00}, // ':'
+    {0x00, 0x56, 0x36, 0x00, 0x00}, // ';'
+    {0x08, 0x14, 0x22, 0x41, 0x00}, // '<'
+    {0x14, 0x14, 0x14, 0x14, 0x14}, // '='
+    {0x00, 0x41, 0x22, 0x14, 0x08}, // '>'
+    {0x02, 0x01, 0x51, 0x09, 0x06}, // '?'
+    {0x32, 0x49, 0x79, 0x41, 0x3E}, // '@'
+    {0x7E, 0x11, 0x11, 0x11, 0x7E}, // 'A'
+    {0x7F, 0x49, 0x49, 0x49, 0x36}, // 'B'
+    {0x3E, 0x41, 0x41, 0x41, 0x22}, // 'C'
+    {0x7F, 0x41, 0x41, 0x22, 0x1C}, // 'D'
+    {0x7F, 0x49, 0x49, 0x49, 0x41}, // 'E'
+    {0x7F, 0x09, 0x09, 0x09, 0x01}, // 'F'
+    {0x3E, 0x41, 0x49, 0x49, 0x7A}, // 'G'
+    {0x7F, 0x08, 0x08, 0x08, 0x7F}, // 'H'
+    {0x00, 0x41, 0x7F, 0x41, 0x00}, // 'I'
+    {0x20, 0x40, 0x41, 0x3F, 0x01}, // 'J'
+    {0x7F, 0x08, 0x14, 0x22, 0x41}, // 'K'
+    {0x7F, 0x40, 0x40, 0x40, 0x40}, // 'L'
+    {0x7F, 0x02, 0x0C, 0x02, 0x7F}, // 'M'
+    {0x7F, 0x04, 0x08, 0x10, 0x7F}, // 'N'
+    {0x3E, 0x41, 0x41, 0x41, 0x3E}, // 'O'
+    {0x7F, 0x09, 0x09, 0x09, 0x06}, // 'P'
+    {0x3E, 0x41, 0x51, 0x21, 0x5E}, // 'Q'
+    {0x7F, 0x09, 0x19, 0x29, 0x46}, // 'R'
+    {0x46, 0x49, 0x49, 0x49, 0x31}, // 'S'
+    {0x01, 0x01, 0x7F, 0x01, 0x01}, // 'T'
+    {0x3F, 0x40, 0x40, 0x40, 0x3F}, // 'U'
+    {0x1F, 0x20, 0x40, 0x20, 0x1F}, // 'V'
+    {0x3F, 0x40, 0x38, 0x40, 0x3F}, // 'W'
+    {0x63, 0x14, 0x08, 0x14, 0x63}, // 'X'
+    {0x07, 0x08, 0x70, 0x08, 0x07}, // 'Y'
+    {0x61, 0x51, 0x49, 0x45, 0x43}, // 'Z'
+    {0x00, 0x7F, 0x41, 0x41, 0x00}, // '['
+    {0x02, 0x04, 0x08, 0x10, 0x20}, // '\'
+    {0x00, 0x41, 0x41, 0x7F, 0x00}, // ']'
+    {0x04, 0x02, 0x01, 0x02, 0x04}, // '^'
+    {0x40, 0x40, 0x40, 0x40, 0x40}, // '_'
+};
+
+/**
+ * @brief Construct a new TextScroller object
+ *
+ * @param eyes Eyes to draw on
+ */
+TextScroller::TextScroller(Eyes &eyes) : eyes(eyes)
+{
+    length = 0;
+    position = 0;
+    defaultMsPerColumn = DEFAULT_MS_PER_COLUMN;
+    msPerColumn = DEFAULT_MS_PER_COLUMN;
+    lastStepTime = 0;
+    active = false;
+    setFont(NULL, 0, 0, 0);
+}
+
+/**
+ * @brief Set the default scrolling speed
+ *
+ * @param msPerColumn Time between two scroll steps (ms)
+ */
+void TextScroller::begin(uint16_t msPerColumn)
+{
+    defaultMsPerColumn = max(msPerColumn, (uint16_t)1);
+}
+
+/**
+ * @brief Use another font
+ *
+ * @param glyphs width bytes per character from first to last, NULL for the
+ *               built-in font
+ */
+void TextScroller::setFont(const uint8_t *glyphs, char first, char last, uint8_t width)
+{
+    if (glyphs == NULL || last < first || width == 0)
+    {
+        glyphs = &FONT[0][0];
+        first = FONT_FIRST;
+        last = FONT_LAST;
+        width = FONT_WIDTH;
+    }
+    this->glyphs = glyphs;
+    fontFirst = first;
+    fontLast = last;
+    fontWidth = width;
+}
+
+/**
+ * @brief Start scrolling a message, replacing the one in progress if any
+ *
+ * @return false if there is nothing to show
+ */
+bool TextScroller::start(const char *message, uint16_t msPerColumn)
+{
+    render(message);
+    if (length == 0)
+    {
+        active = false;
+        return false;
+    }
+
+    this->msPerColumn = msPerColumn ? msPerColumn : defaultMsPerColumn;
+    position = 0;
+    active = true;
+    // First column comes in on the next update()
+    lastStepTime = millis() - this->msPerColumn;
+    return true;
+}
+
+/**
+ * @brief Stop the message in progress
+ */
+void TextScroller::stop()
+{
+    active = false;
+}
+
+/**
+ * @brief Scroll when a step is due
+ *
+ * @return true while a message is scrolling
+ */
+bool TextScroller::update()
+{
+    if (!active)
+    {
+        return false;
+    }
+
+    unsigned long now = millis();
+    if (now - lastStepTime < msPerColumn)
+    {
+        return true;
+    }
+    // Keep the pace steady, but do not rush to catch up after a stall
+    lastStepTime = (now - lastStepTime < 2UL * msPerColumn) ? lastStepTime + msPerColumn : now;
+
+    position++;
+    if (position >= length + EYES_CANVAS_WIDTH)
+    {
+        // Last column has left the canvas, give the displays back
+        active = false;
+        return false;
+    }
+
+    draw();
+    return true;
+}
+
+/**
+ * @brief Check if a message is scrolling
+ */
+bool TextScroller::isActive()
+{
+    return active;
+}
+
+/**
+ * @brief Time until the next scroll step
+ */
+uint32_t TextScroller::timeUntilNextStep()
+{
+    if (!active)
+    {
+        return UINT32_MAX;
+    }
+    unsigned long elapsed = millis() - lastStepTime;
+    return elapsed >= msPerColumn ? 0 : (msPerColumn - elapsed) * 1000UL;
+}
+
+/**
+ * @brief Render the message into column bitmaps
+ *
+ * Blank glyph columns are trimmed and one blank column separates glyphs.
+ */
+void TextScroller::render(const char *message)
+{
+    length = 0;
+
+    for (uint8_t i = 0; message[i] != '\0' && i < TEXT_MAX_LENGTH; i++)
+    {
+        char c = message[i];
+        if ((c < fontFirst || c > fontLast) && c >= 'a' && c <= 'z')
+        {
+            c -= 'a' - 'A';
+        }
+        if (c < fontFirst || c > fontLast)
+        {
+            c = '?';
+        }
+
+        // Stop at the first glyph that does not fit
+        if (length + (fontWidth > SPACE_WIDTH ? fontWidth : SPACE_WIDTH) + 1 > TEXT_MAX_COLUMNS)
+        {
+            break;
+        }
+
+        if (c == ' ')
+        {
+            for (uint8_t col = 0; col < SPACE_WIDTH; col++)
+            {
+                columns[length++] = 0x00;
+            }
+            continue;
+        }
+        if (c < fontFirst || c > fontLast)
+        {
+            continue; // Not even '?' in the font
+        }
+
+        const uint8_t *glyph = glyphs + (uint16_t)(c - fontFirst) * fontWidth;
+        uint8_t first = 0;
+        uint8_t last = fontWidth - 1;
+        while (first < last && glyph[first] == 0x00)
+        {
+            first++;
+        }
+        while (last > first && glyph[last] == 0x00)
+        {
+            last--;
+        }
+
+        for (uint8_t col = first; col <= last; col++)
+        {
+            columns[length++] = glyph[col];
+        }
+        columns[length++] = 0x00; // Spacing
+    }
+
+    // Only blank columns (e.g. "  "): nothing to show
+    bool blank = true;
+    for (uint16_t col = 0; col < length && blank; col++)
+    {
+        blank = (columns[col] == 0x00);
+    }
+    if (blank)
+    {
+        length = 0;
+    }
+}
+
+/**
+ * @brief Draw the visible window of the message
+ *
+ * The message enters from the right: at position p, canvas column c shows
+ * message column p + c - EYES_CANVAS_WIDTH.
+ */
+void TextScroller::draw()
+{
+    uint8_t canvas[EYES_CANVAS_WIDTH];
+    for (uint8_t c = 0; c < EYES_CANVAS_WIDTH; c++)
+    {
+        int16_t col = (int16_t)position + c - EYES_CANVAS_WIDTH;
+        canvas[c] = (col >= 0 && col < length) ? columns[col] : 0x00;
+    }
+    eyes.drawCanvas(canvas);
+}
@@ -0,0 +1,120 @@
+#ifndef TEXT_SCROLLER_H
+#define TEXT_SCROLLER_H
+
+#include <Arduino.h>
+#include <Eyes.h>
+
+// Longest message, longer ones are truncated
+#define TEXT_MAX_LENGTH 48
+// Rendered message size: 5 columns per glyph plus spacing, at most with
+// the built-in font. Wider fonts truncate long messages
+#define TEXT_MAX_COLUMNS (TEXT_MAX_LENGTH * 6)
+
+/**
+ * @brief TextScroller class, scrolls short messages across both eyes
+ *
+ * Messages are rendered once with a 5x7 font into column bitmaps, then
+ * scrolled one column at a time across the 16-column canvas of the Eyes.
+ * Glyphs are proportional (blank columns trimmed) so that "BOO" almost fits
+ * on the two displays. The built-in font covers printable ASCII up to '_'.
+ * Characters missing from the font are shown in uppercase if it has them,
+ * else as '?'.
+ *
+ * While a message scrolls, the scroller owns the displays: do not call
+ * Eyes::update(), only Eyes::updateIntensity(). Once the message has left
+ * the canvas, update() returns false and Eyes::update() takes the displays
+ * back.
+ */
+class TextScroller
+{
+public:
+    /**
+     * @brief Construct a new TextScroller object
+     *
+     * @param eyes Eyes to draw on
+     */
+    TextScroller(Eyes &eyes);
+
+    /**
+     * @brief Set the default scrolling speed
+     *
+     * @param msPerColumn Time between two scroll steps (ms)
+     */
+    void begin(uint16_t msPerColumn);
+
+    /**
+     * @brief Use another font
+     *
+     * One byte per column, left to right, bit 0 is the top row.
+     *
+     * @param glyphs width bytes per character from first to last, must
+     *               outlive the object (e.g. an asset pack), NULL for the
+     *               built-in font
+     * @param first First character
+     * @param last Last character
+     * @param width Columns per glyph
+     */
+    void setFont(const uint8_t *glyphs, char first, char last, uint8_t width);
+
+    /**
+     * @brief Start scrolling a message, replacing the one in progress if any
+     *
+     * The message enters from the right and scrolls until it has fully left
+     * the canvas on the left.
+     *
+     * @param message Text to show, rendered right away so it need not stay valid
+     * @param msPerColumn Time between two scroll steps (ms), 0 for the default
+     *
+     * @return false if there is nothing to show
+     */
+    bool start(const char *message, uint16_t msPerColumn = 0);
+
+    /**
+     * @brief Stop the message in progress
+     */
+    void stop();
+
+    /**
+     * @brief Scroll when a step is due (call this in loop())
+     *
+     * @return true while a message is scrolling
+     */
+    bool update();
+
+    /**
+     * @brief Check if a message is scrolling
+     */
+    bool isActive();
+
+    /**
+     * @brief Time until the next scroll step
+     *
+     * @return Microseconds until the next step, UINT32_MAX if not scrolling
+     */
+    uint32_t timeUntilNextStep();
+
+private:
+    Eyes &eyes;
+
+    // Font in use
+    const uint8_t *glyphs;
+    char fontFirst;
+    char fontLast;
+    uint8_t fontWidth;
+
+    uint8_t columns[TEXT_MAX_COLUMNS]; // Rendered message
+    uint16_t length;                   // Used columns
+    uint16_t position;                 // Columns scrolled in so far
+    uint16_t defaultMsPerColumn;
+    uint16_t msPerColumn;
+    unsigned long lastStepTime;
+    bool active;
+
+    static const uint8_t SPACE_WIDTH = 3; // Columns of a space
+    static const uint16_t DEFAULT_MS_PER_COLUMN = 60;
+
+    void render(const char *message);
+    void draw();
+};
+
+#endif // TEXT_SCROLLER_H
@@ -0,0 +1,149 @@
+#include "Ws2812Display.h"
+
+// Two RMT memory blocks: half as many refill interrupts while sending
+#define WS2812_RMT_MEMORY RMT_MEM_NUM_BLOCKS_2
+#define WS2812_GAMMA 2.2f
+
+static_assert(sizeof(rmt_data_t) == sizeof(uint32_t), "RMT symbol layout");
+
+static const Ws2812Timing timing = WS2812_TIMING;
+
+/**
+ * @brief Construct a new Ws2812Display object
+ */
+Ws2812Display::Ws2812Display(uint8_t pin, const Ws2812Palette &palette, bool serpentine)
+{
+    this->pin = pin;
+    this->palette = palette;
+    this->serpentine = serpentine;
+    available = false;
+    for (uint8_t i = 0; i < 8; i++)
+    {
+        left[i] = 0x00;
+        right[i] = 0x00;
+        shape[i] = 0x00;
+    }
+    hasShape = false;
+    lidMask = 0xFF;
+    intensity = 0;
+    shutdown = false;
+    pending = false;
+}
+
+/**
+ * @brief Set up the RMT channel and clear the panels
+ */
+void Ws2812Display::begin()
+{
+    available = rmtInit(pin, RMT_TX_MODE, WS2812_RMT_MEMORY, WS2812_RMT_FREQUENCY);
+    if (!available)
+    {
+        Serial.println("WS2812: RMT initialization failed");
+    }
+    ws2812BuildGamma(WS2812_GAMMA, gamma);
+    ws2812BuildLut(gamma, intensity, lut);
+    pending = true;
+    transmit();
+}
+
+/**
+ * @brief Set the intensity (0-15), rebuilds the LUT
+ */
+void Ws2812Display::setIntensity(uint8_t intensity)
+{
+    if (intensity == this->intensity)
+    {
+        return;
+    }
+    this->intensity = intensity;
+    ws2812BuildLut(gamma, intensity, lut);
+    pending = true;
+    transmit();
+}
+
+/**
+ * @brief Turn all the LEDs off, or show the last frame again
+ *
+ * The WS2812 still draw ~1mA each while off.
+ */
+void Ws2812Display::setShutdown(bool shutdown)
+{
+    if (shutdown == this->shutdown)
+    {
+        return;
+    }
+    this->shutdown = shutdown;
+    pending = true;
+    transmit();
+}
+
+/**
+ * @brief Show a frame, sent in the background
+ *
+ * @return Number of rows transferred, always all of them
+ */
+uint8_t Ws2812Display::show(const EyesFrame &frame)
+{
+    for (uint8_t i = 0; i < 8; i++)
+    {
+        left[i] = frame.left[i];
+        right[i] = frame.right[i];
+        shape[i] = frame.shape != NULL ? frame.shape[i] : 0x00;
+    }
+    hasShape = (frame.shape != NULL);
+    lidMask = frame.lidMask;
+    pending = true;
+    transmit();
+    return 16;
+}
+
+/**
+ * @brief Send the pending frame once the RMT is free
+ */
+void Ws2812Display::update()
+{
+    if (pending)
+    {
+        transmit();
+    }
+}
+
+/**
+ * @brief Check if a frame is being sent
+ *
+ * The RMT stops in light sleep: do not sleep while busy.
+ */
+bool Ws2812Display::isBusy()
+{
+    return available && (pending || !rmtTransmitCompleted(pin));
+}
+
+/**
+ * @brief Render, encode and start sending the pending frame, if the RMT is free
+ */
+void Ws2812Display::transmit()
+{
+    if (!available || !rmtTransmitCompleted(pin))
+    {
+        return; // Sent by update() when the current frame is done
+    }
+
+    if (shutdown)
+    {
+        memset(grb, 0, sizeof(grb));
+    }
+    else
+    {
+        EyesFrame frame = {
+            .left = left,
+            .right = right,
+            .shape = hasShape ? shape : NULL,
+            .lidMask = lidMask,
+        };
+        ws2812Render(frame, palette, lut, serpentine, grb);
+    }
+
+    size_t count = ws2812Encode(grb, sizeof(grb), timing, symbols);
+    rmtWriteAsync(pin, (rmt_data_t *)symbols, count);
+    pending = false;
+}
@@ -0,0 +1,64 @@
+#ifndef WS2812_DISPLAY_H
+#define WS2812_DISPLAY_H
+
+#include <Arduino.h>
+#include <EyesDisplay.h>
+#include "Ws2812Encoder.h"
+
+/**
+ * @brief Eyes backend for two chained 8x8 WS2812 RGB panels
+ *
+ * Frames are rendered with a color per layer (sclera, iris, lids) through a
+ * gamma and intensity LUT, encoded into RMT symbols and sent in the
+ * background: show() returns right away and the RMT driver streams the
+ * symbols while the CPU carries on. A frame drawn while the previous one is
+ * still being sent is kept and sent by update() once the RMT is free, only
+ * the latest one.
+ *
+ * A frame takes ~3.7ms to send, which caps the refresh rate at ~270Hz.
+ */
+class Ws2812Display : public EyesDisplay
+{
+public:
+    /**
+     * @brief Construct a new Ws2812Display object
+     *
+     * @param pin Data pin of the first panel (right eye)
+     * @param palette Color of each layer
+     * @param serpentine Odd rows of the panels are wired right to left
+     */
+    Ws2812Display(uint8_t pin, const Ws2812Palette &palette, bool serpentine);
+
+    void begin() override;
+    void setIntensity(uint8_t intensity) override;
+    void setShutdown(bool shutdown) override;
+    uint8_t show(const EyesFrame &frame) override;
+    void update() override;
+    bool isBusy() override;
+
+private:
+    uint8_t pin;
+    Ws2812Palette palette;
+    bool serpentine;
+    bool available;
+
+    // Last frame, copied: the next one is drawn while this one is sent
+    uint8_t left[8];
+    uint8_t right[8];
+    uint8_t shape[8];
+    bool hasShape;
+    uint8_t lidMask;
+
+    uint8_t intensity;
+    bool shutdown;
+    bool pending; // Frame waiting for the RMT to be free
+
+    uint16_t gamma[256];
+    uint8_t lut[256];
+    uint8_t grb[WS2812_FRAME_BYTES];
+    uint32_t symbols[WS2812_FRAME_SYMBOLS];
+
+    void transmit();
+};
+
+#endif // WS2812_DISPLAY_H
@@ -0,0 +1,83 @@
+#include "Ws2812Encoder.h"
+#include <math.h>
+
+uint32_t ws2812Symbol(uint16_t highTicks, uint16_t lowTicks)
+{
+    return ((uint32_t)(highTicks & 0x7FFF)) | (1UL << 15) |
+           ((uint32_t)(lowTicks & 0x7FFF) << 16); // level1 = 0
+}
+
+void ws2812BuildGamma(float gamma, uint16_t *table)
+{
+    for (uint16_t i = 0; i < 256; i++)
+    {
+        table[i] = (uint16_t)(powf(i / 255.0f, gamma) * 65535.0f + 0.5f);
+    }
+}
+
+void ws2812BuildLut(const uint16_t *gamma, uint8_t intensity, uint8_t *lut)
+{
+    uint32_t duty = 2 * (uint32_t)(intensity > 15 ? 15 : intensity) + 1; // x/32
+    for (uint16_t i = 0; i < 256; i++)
+    {
+        // 16-bit duty scaled down to 8 bits, rounded
+        lut[i] = (uint8_t)(((uint32_t)gamma[i] * duty / 32 + 128) >> 8);
+    }
+}
+
+void ws2812Render(const EyesFrame &frame, const Ws2812Palette &palette, const uint8_t *lut,
+                  bool serpentine, uint8_t *grb)
+{
+    static const Ws2812Color BLACK = {0, 0, 0};
+
+    for (uint8_t eye = 0; eye < 2; eye++)
+    {
+        const uint8_t *rows = (eye == 0) ? frame.right : frame.left;
+
+        for (uint8_t y = 0; y < 8; y++)
+        {
+            // The displays are tilted: buffer rows are columns, bit 7 is the top
+            uint8_t bit = 0x80 >> y;
+
+            for (uint8_t x = 0; x < 8; x++)
+            {
+                const Ws2812Color *color = &BLACK;
+                if (rows[x] & bit)
+                {
+                    color = &palette.sclera;
+                }
+                else if (frame.shape != NULL && (frame.shape[x] & bit))
+                {
+                    color = (frame.lidMask & bit) ? &palette.iris : &palette.lid;
+                }
+
+                uint8_t column = (serpentine && (y & 1)) ? 7 - x : x;
+                uint8_t *pixel = grb + 3 * (eye * WS2812_EYE_PIXELS + y * 8 + column);
+                pixel[0] = lut[color->g];
+                pixel[1] = lut[color->r];
+                pixel[2] = lut[color->b];
+            }
+        }
+    }
+}
+
+size_t ws2812Encode(const uint8_t *data, size_t length, const Ws2812Timing &timing, uint32_t *symbols)
+{
+    const uint32_t zero = ws2812Symbol(timing.t0h, timing.t0l);
+    const uint32_t one = ws2812Symbol(timing.t1h, timing.t1l);
+    size_t count = 0;
+
+    for (size_t i = 0; i < length; i++)
+    {
+        uint8_t byte = data[i];
+        for (uint8_t mask = 0x80; mask != 0; mask >>= 1)
+        {
+            symbols[count++] = (byte & mask) ? one : zero;
+        }
+    }
+
+    // Both halves low: the line stays low long enough to latch the frame
+    uint16_t half = timing.reset / 2;
+    symbols[count++] = (uint32_t)half | ((uint32_t)half << 16);
+    return count;
+}
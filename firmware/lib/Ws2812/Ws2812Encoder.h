@@ -0,0 +1,107 @@
+#ifndef WS2812_ENCODER_H
+#define WS2812_ENCODER_H
+
+// Pure C++ (no Arduino dependency) so it can be unit tested on the host
+
+#include <stdint.h>
+#include <stddef.h>
+#include <EyesDisplay.h>
+
+#define WS2812_EYE_PIXELS 64                          // One 8x8 panel per eye
+#define WS2812_PIXELS (2 * WS2812_EYE_PIXELS)         // Right eye panel first
+#define WS2812_FRAME_BYTES (WS2812_PIXELS * 3)        // GRB
+#define WS2812_FRAME_SYMBOLS (WS2812_FRAME_BYTES * 8 + 1) // One per bit, plus the reset
+
+typedef struct
+{
+    uint8_t r;
+    uint8_t g;
+    uint8_t b;
+} Ws2812Color;
+
+/**
+ * @brief Color of each layer of the eyes
+ *
+ * Colors are perceptual (as picked in a color picker), the gamma correction
+ * is applied when rendering.
+ */
+typedef struct
+{
+    Ws2812Color sclera; // Lit pixels (also scrolling text)
+    Ws2812Color iris;   // Pixels of the eye left off for the iris
+    Ws2812Color lid;    // Pixels of the eye covered by the lids
+} Ws2812Palette;
+
+/**
+ * @brief Bit timings, in RMT ticks
+ */
+typedef struct
+{
+    uint16_t t0h;   // High time of a 0 bit
+    uint16_t t0l;   // Low time of a 0 bit
+    uint16_t t1h;   // High time of a 1 bit
+    uint16_t t1l;   // Low time of a 1 bit
+    uint16_t reset; // Low time latching the frame (split over the two halves of a symbol)
+} Ws2812Timing;
+
+// WS2812B timings for a 10MHz RMT clock: 1.2us bits, 300us reset
+#define WS2812_RMT_FREQUENCY 10000000
+#define WS2812_TIMING {.t0h = 4, .t0l = 8, .t1h = 8, .t1l = 4, .reset = 3000}
+
+/**
+ * @brief Build an RMT symbol: high for highTicks, then low for lowTicks
+ *
+ * Same layout as the ESP32 RMT symbols (rmt_data_t): duration0 in bits 0-14,
+ * level0 in bit 15, duration1 in bits 16-30, level1 in bit 31.
+ */
+uint32_t ws2812Symbol(uint16_t highTicks, uint16_t lowTicks);
+
+/**
+ * @brief Build the gamma table: perceptual 8-bit level to 16-bit PWM duty
+ *
+ * @param gamma Gamma exponent (2.2 for the usual perceptual curve)
+ * @param table 256 entries
+ */
+void ws2812BuildGamma(float gamma, uint16_t *table);
+
+/**
+ * @brief Build the output LUT for an intensity
+ *
+ * Combines the gamma table with the duty cycle the MAX7219 would have at
+ * this intensity register value, (2 * intensity + 1) / 32, so both backends
+ * dim the same way.
+ *
+ * @param gamma Gamma table from ws2812BuildGamma()
+ * @param intensity Intensity register value (0-15)
+ * @param lut 256 entries, perceptual level to LED PWM value
+ */
+void ws2812BuildLut(const uint16_t *gamma, uint8_t intensity, uint8_t *lut);
+
+/**
+ * @brief Render a frame of both eyes into GRB pixels
+ *
+ * Panels are wired row by row from the top left pixel, the right eye panel
+ * first.
+ *
+ * @param frame Frame drawn by the Eyes class
+ * @param palette Color of each layer
+ * @param lut Output LUT from ws2812BuildLut()
+ * @param serpentine Odd rows are wired right to left
+ * @param grb WS2812_FRAME_BYTES bytes
+ */
+void ws2812Render(const EyesFrame &frame, const Ws2812Palette &palette, const uint8_t *lut,
+                  bool serpentine, uint8_t *grb);
+
+/**
+ * @brief Encode bytes into RMT symbols, MSB first, followed by the reset
+ *
+ * @param data Bytes to send
+ * @param length Number of bytes
+ * @param timing Bit timings
+ * @param symbols length * 8 + 1 symbols
+ *
+ * @return Number of symbols written
+ */
+size_t ws2812Encode(const uint8_t *data, size_t length, const Ws2812Timing &timing, uint32_t *symbols);
+
+#endif // WS2812_ENCODER_H
@@ -7,33 +7,127 @@
 #define CLK_PIN 18  // Clock pin
 #define DATA_PIN 23 // MOSI pin (Data In)
 #define CS_PIN 5    // Chip Select pin
+// Use the hardware SPI (VSPI, its default pins are CLK_PIN and DATA_PIN above)
+// instead of bit-banging: needed for the high refresh rate of smooth gaze
+#define EYES_HARDWARE_SPI 1
 
-#define CLOSED_MODE_PROBABILITY 10 // Probability of entering CLOSED mode each update cycle (percent)
+// Display backend: 0 for MAX7219 modules, 1 for 8x8 WS2812 RGB panels
+#define EYES_WS2812 0
+#define WS2812_PIN 23 // Data in of the right eye panel, the left eye panel is chained after it
+#define WS2812_SERPENTINE 0 // Set to 1 for panels with odd rows wired right to left
+#define WS2812_PALETTE { \
+    .sclera = {255, 24, 0}, /* Red glow */ \
+    .iris = {0, 255, 0},    /* Green iris */ \
+    .lid = {40, 0, 0},      /* Dim red lids */ \
+}
 
-#define MIN_RANDOM_DELAY 1000 // Minimum random delay between animations (ms)
-#define MAX_RANDOM_DELAY 5000 // Maximum random delay between animations (ms)
+// Smooth gaze: irises glide between pixels with temporal dithering
+#define EYES_REFRESH_RATE 250 // Frame rate while gliding (Hz), 0 for pixel steps, WS2812 max ~270Hz
+#define EYES_GAZE_SPEED 20 // Iris speed while gliding (pixels per second)
 
-#define MIN_RANDOM_DELAY_CLOSED 3000 // Minimum random delay between CLOSED mode animations (ms)
-#define MAX_RANDOM_DELAY_CLOSED 6000 // Maximum random delay between CLOSED mode animations (ms)
+// Behavior personality, see lib/Behavior/Personalities.h
+// (personalityClassic, personalitySleepy, personalityNervous)
+#define BEHAVIOR_PERSONALITY personalityClassic
 
 #define EYES_BRIGHTNESS 8 // Default display brightness (0-15)
 
+// Intensity effects, levels are perceptual (0-255 of the current brightness)
+#define BREATHING_MIN_LEVEL 140 // Dimmest level of the idle breathing glow
+#define BREATHING_PERIOD 5000 // Duration of a breathing cycle (ms)
+#define INTENSITY_FADE_TIME 300 // Fade back to full level when leaving idle (ms)
+
+// Scrolling text
+#define TEXT_SCROLL_SPEED 60 // Time between two scroll steps (ms per column)
+#define TEXT_SWAP_PANELS 0 // Set to 1 if the text starts on the wrong eye
+#define TEXT_MIRROR_COLUMNS 0 // Set to 1 if the glyphs show up mirrored
+
+// Clips packed in the audio partition (custom_fast_sounds in platformio.ini)
+// play on the DAC within a few ms, the others on the DFPlayer. Needs an
+// amplifier on the DAC pin
+#define FAST_AUDIO_DAC -1 // 0: GPIO 25, 1: GPIO 26, -1 to play everything on the DFPlayer
+
+// Ambient light adaptive brightness (LDR from 3V3 to pin, resistor to GND)
+#define AMBIENT_LIGHT_ENABLED 0 // Set to 1 once the LDR is fitted, else EYES_BRIGHTNESS is used
+#define LDR_PIN 34 // Must be an ADC1 pin (GPIO 32-39)
+
+#define AMBIENT_LIGHT_CONFIG { \
+    .darkRaw = 200, \
+    .brightRaw = 3500, \
+    .minLevel = 0, \
+    .maxLevel = 15, \
+    .filterShift = 5, \
+    .hysteresis = 80, \
+    .oneshot = FAST_AUDIO_DAC >= 0 /* The DAC DMA takes I2S0 */ \
+}
+
 // DFPlayer Mini configuration
-#define DFPLAYER_RX 16  // ESP32 RX2 → DFPlayer TX
-#define DFPLAYER_TX 17  // ESP32 TX2 → DFPlayer RX
+#define DFPLAYER_RX 16  // ESP32 RX → DFPlayer TX
+#define DFPLAYER_TX 17  // ESP32 TX → DFPlayer RX
+#define DFPLAYER_UART 1 // UART1, only UART0/1 can wake the ESP32 from light sleep
+
+#define SPEECH_FOLDER 1
+#define YAWNING_FOLDER 2
+#define EFFECT_FOLDER 3
 
 #define DFPLAYER_CONFIG { \
     .volume = 30, \
-    .yawningFolder = 2, \
-    .speechFolder = 1, \
-    .effectFolder = 3, \
+    .yawningFolder = YAWNING_FOLDER, \
+    .speechFolder = SPEECH_FOLDER, \
+    .effectFolder = EFFECT_FOLDER, \
     .yawningNbSounds = 3, \
     .speechNbSounds = 9, \
-    .effectNbSounds = 6 \
+    .effectNbSounds = 6, \
+    .fastAudioDac = FAST_AUDIO_DAC \
 }
 
 #define MIN_SOUND_DELAY 20000 // Minimum delay between sounds (ms)
 #define MAX_SOUND_DELAY 60000 // Maximum delay between sounds (ms)
 #define MIN_YAWNING_INTERVAL 20000 // Yawning may come sooner than other sounds (ms)
 
+// Multi-skull bus (RS-485 transceiver on UART2): one leader paces the sounds
+// of all skulls and sends group gaze moves and scenes
+#define SKULL_BUS_ROLE SKULL_BUS_OFF // SKULL_BUS_LEADER on one skull, SKULL_BUS_FOLLOWER on the others
+#define SKULL_ID 0 // 0 for the leader, 1 to skullCount - 1 for the followers
+#define SKULL_BUS_UART 2
+#define SKULL_BUS_RX 32 // ESP32 RX ← RO (GPIO 25/26 are the DAC)
+#define SKULL_BUS_TX 33 // ESP32 TX → DI
+#define SKULL_BUS_DE 27 // ESP32 RTS → DE and /RE, -1 without transceiver (two skulls only)
+#define SKULL_BUS_LEAD 100 // Time for the followers to receive a group command before all apply it (ms)
+
+#define SKULL_BUS_CONFIG { \
+    .skullCount = 3, \
+    .baudRate = 115200, \
+    .slotMs = 20000, /* Longer than the longest sound */ \
+    .tokenGapMinMs = 5000, \
+    .tokenGapMaxMs = 20000, \
+}
+
+// Scenes configuration
+#define SCENE_RESUME_DELAY 1000 // Time before autonomous behavior resumes after a scene (ms)
+
+// Low power configuration
+#define LOOP_PERIOD 25 // Time between loop iterations (ms)
+// Light sleep between loop iterations instead of delay(). Opt-in: the UART
+// byte that wakes the CPU is lost, so a DFPlayer message (e.g. a track end)
+// arriving during sleep is dropped and only caught by the next status query
+#define LOW_POWER_LIGHT_SLEEP 0
+#define LIGHT_SLEEP_MIN_TIME 2000 // Shorter waits spin instead of sleeping (us)
+#define LIGHT_SLEEP_WAKEUP_MARGIN 1000 // Wake up this early, then spin until the deadline (us)
+#define CONSOLE_AWAKE_TIME 10000 // Stay awake after serial input to receive commands (ms)
+
+// Power estimation (currents in uA), see PowerMonitor.h
+#define POWER_REPORT_INTERVAL 3600000 // Time between power reports on serial (ms)
+
+#define POWER_MODEL { \
+    .supplyMillivolts = 5000, \
+    .cpuActive = 40000, \
+    .cpuLightSleep = 800, \
+    .displayDevices = 2, \
+    .displayQuiescent = 8000, \
+    .displayShutdown = 150, \
+    .displaySegmentPeak = 40000, \
+    .audioIdle = 20000, \
+    .audioPlaying = 120000 \
+}
+
 #endif // CONFIG_H
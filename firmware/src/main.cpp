@@ -1,99 +1,296 @@
 #include <Arduino.h>
 #include <esp_sleep.h>
-#include <DFRobotDFPlayerMini.h>
+#include <driver/gpio.h>
+#include <driver/uart.h>
 #include <HardwareSerial.h>
 #include <Eyes.h>
+#include <Max7219Display.h>
+#include <Ws2812Display.h>
 #include <Sounds.h>
+#include <AmbientLight.h>
+#include <PowerMonitor.h>
+#include <Behavior.h>
+#include <Personalities.h>
+#include <Choreography.h>
+#include <TextScroller.h>
+#include <SkullBus.h>
+#include <SkullBusSerial.h>
+#include <AssetPack.h>
 #include "config.h"
+#include "scenes.h"
 
 void animateEyes();
 void maybePlaySound(bool yawn = false);
+bool soundAllowed(bool yawn);
+unsigned long idle(unsigned long us);
+bool onSceneEvent(const SceneEvent &event);
+void startScene(const Scene &scene);
+void playScene(const Scene &scene);
+void applyBusCommands();
+void handleSerial();
+void loadAssets(SoundsConfig &config);
+uint8_t autoBrightness();
 
 static const SoundsConfig soundConfig = DFPLAYER_CONFIG;
+static const AmbientLightConfig ambientLightConfig = AMBIENT_LIGHT_CONFIG;
+static const PowerModel powerModel = POWER_MODEL;
+static const SkullBusConfig skullBusConfig = SKULL_BUS_CONFIG;
 
-// Create Eyes object
-Eyes eyes(HARDWARE_TYPE, DATA_PIN, CLK_PIN, CS_PIN);
+// Create Eyes object on the selected display backend
+#if EYES_WS2812
+static const Ws2812Palette eyesPalette = WS2812_PALETTE;
+Ws2812Display eyesDisplay(WS2812_PIN, eyesPalette, WS2812_SERPENTINE);
+#elif EYES_HARDWARE_SPI
+Max7219Display eyesDisplay(HARDWARE_TYPE, CS_PIN);
+#else
+Max7219Display eyesDisplay(HARDWARE_TYPE, DATA_PIN, CLK_PIN, CS_PIN);
+#endif
+Eyes eyes(eyesDisplay);
 
 // Create DFPlayer object
-Sounds sounds(DFPLAYER_RX, DFPLAYER_TX);
+Sounds sounds(DFPLAYER_RX, DFPLAYER_TX, DFPLAYER_UART);
 
-enum EyePosition
-{
-  TOP,
-  BOTTOM,
-  LEFT,
-  RIGHT,
-  CENTER,
-  TOP_LEFT,
-  TOP_RIGHT,
-  BOTTOM_LEFT,
-  BOTTOM_RIGHT,
-  CENTER_LEFT,
-  CENTER_RIGHT,
-  TOP_CENTER,
-  BOTTOM_CENTER,
-};
-
-typedef struct
-{
-  uint8_t x;
-  uint8_t y;
-} Position;
-
-Position eyePositions[] = {
-    {3, 6}, // TOP
-    {3, 0}, // BOTTOM
-    {0, 3}, // LEFT
-    {6, 3}, // RIGHT
-    {3, 3}, // CENTER
-    {1, 5}, // TOP_LEFT
-    {5, 5}, // TOP_RIGHT
-    {1, 1}, // BOTTOM_LEFT
-    {5, 1}, // BOTTOM_RIGHT
-    {4, 3}, // CENTER_LEFT
-    {2, 3}, // CENTER_RIGHT
-    {3, 4}, // TOP_CENTER
-    {3, 2}  // BOTTOM_CENTER
-};
+// Create ambient light sensor object
+AmbientLight ambientLight(LDR_PIN);
+bool ambientLightAvailable = false;
+
+// Create power consumption estimator
+PowerMonitor power(powerModel);
+
+// Create behavior engine with the personality selected in config.h
+Behavior behavior(BEHAVIOR_PERSONALITY);
+
+// Create scene player
+Choreography choreography;
+bool sceneActive = false;
+bool brightnessOverride = false; // A scene controls the brightness
+
+// Create text scroller, it borrows the eye displays while a message scrolls
+TextScroller text(eyes);
+
+// Create multi-skull bus
+SkullBusSerial busPort(SKULL_BUS_UART, SKULL_BUS_RX, SKULL_BUS_TX, SKULL_BUS_DE);
+SkullBus bus(busPort);
+
+// Create asset pack, read in place from its flash partition
+AssetPack assets;
+// Gaze targets of the behavior engine, from the asset pack or built in
+const BehaviorPosition *gazePositions = behaviorPositions;
 
 EyeMode currentMode = NORMAL;
 
 unsigned long lastAnimationEndTime = 0;
-unsigned long randomDelay = 0;
+unsigned long dwellTime = 0;
 
 unsigned long lastSoundTime = 0;
 unsigned long soundDelay = 0;
 
-bool dfPlayerAvailable = false;
+unsigned long consoleAwakeUntil = 0;
 
 void setup()
 {
   // Initialize serial communication
   Serial.begin(115200);
+
+  // Load the asset pack, built-in assets are used for anything it lacks
+  SoundsConfig soundsConfig = soundConfig;
+  loadAssets(soundsConfig);
   
   // Initialize DFPlayer
-  sounds.begin(soundConfig);
+  sounds.begin(soundsConfig);
   
   // Initialize eyes
   eyes.begin();
   eyes.immediatePosition(3, 3); // Center
   eyes.setBrightness(EYES_BRIGHTNESS);
+  eyes.setSmoothGaze(EYES_REFRESH_RATE, EYES_GAZE_SPEED);
   eyes.immediateMode(CLOSED);
   eyes.requestMode(NORMAL); // Start with animation of opening eyes
+  eyes.setCanvasOrientation(TEXT_SWAP_PANELS, TEXT_MIRROR_COLUMNS);
+  text.begin(TEXT_SCROLL_SPEED);
+
+  // Initialize behavior engine
+  behavior.begin();
+  Serial.printf("Behavior personality: %s\n", behavior.getName());
+
+  // Initialize scene player
+  choreography.begin(onSceneEvent);
+
+  // Join the skull bus
+  if (SKULL_BUS_ROLE != SKULL_BUS_OFF)
+  {
+    busPort.begin(skullBusConfig.baudRate);
+    bus.begin(SKULL_BUS_ROLE, SKULL_ID, skullBusConfig, micros());
+  }
+
+#if AMBIENT_LIGHT_ENABLED
+  // Initialize ambient light sensor, falls back to EYES_BRIGHTNESS on failure
+  ambientLightAvailable = ambientLight.begin(ambientLightConfig);
+#endif
 }
 
 void loop()
 {
+  unsigned long loopStart = micros();
+
+  // Scene events first, they are the most time sensitive
+  choreography.update();
+  handleSerial();
+  bus.update(micros(), sounds.isPlaying());
+  applyBusCommands();
+
+  if (ambientLightAvailable && ambientLight.update() && !brightnessOverride)
+  {
+    eyes.setBrightness(ambientLight.getLevel());
+  }
+  sounds.update();
   animateEyes();
-  maybePlaySound();
-  delay(25);
-  // Below breaks dfPlayer operation
-  //esp_sleep_enable_timer_wakeup(25 * 1000); // 25ms in microseconds
-  //esp_light_sleep_start();
+  if (!choreography.isRunning())
+  {
+    maybePlaySound();
+  }
+
+  // Wake up in time for the next scene event, scroll step or gliding frame
+  unsigned long wait = min((uint32_t)LOOP_PERIOD * 1000, choreography.timeUntilNext());
+  wait = min((uint32_t)wait, text.timeUntilNextStep());
+  wait = min((uint32_t)wait, eyes.timeUntilNextFrame());
+  unsigned long slept = idle(wait);
+
+  PowerState powerState = {
+      .litPixels = eyes.litPixels(),
+      .brightness = eyes.getBrightness(),
+      .displayShutdown = eyes.isShutdown(),
+      .audioPlaying = sounds.isPlaying(),
+  };
+  power.account(micros() - loopStart, slept, powerState);
+  if (power.update(Serial, POWER_REPORT_INTERVAL))
+  {
+    SoundsStats stats = sounds.getStats();
+    Serial.printf("[sounds] %s, disconnects %lu, recoveries %lu, unavailable %lu s, timeouts %lu, errors %lu\n",
+                  sounds.isAvailable() ? "online" : "offline",
+                  (unsigned long)stats.disconnects, (unsigned long)stats.recoveries,
+                  (unsigned long)(stats.unavailableMs / 1000), (unsigned long)stats.timeouts,
+                  (unsigned long)stats.errorFrames);
+    if (sounds.isFastAudioAvailable())
+    {
+      Serial.printf("[audio] flash clips %lu, underruns %lu, max start latency %lu us\n",
+                    (unsigned long)stats.fastAudio.plays, (unsigned long)stats.fastAudio.underruns,
+                    (unsigned long)stats.fastAudio.maxStartLatencyUs);
+    }
+
+    if (SKULL_BUS_ROLE != SKULL_BUS_OFF)
+    {
+      SkullBusStats busStats = bus.getStats();
+      Serial.printf("[bus] %s, frames %lu, dropped %lu, leader lost %lu, max clock correction %lu us, tokens %lu\n",
+                    bus.isActive() ? "active" : "no leader",
+                    (unsigned long)busStats.framesReceived, (unsigned long)busStats.framesDropped,
+                    (unsigned long)busStats.leaderLost, (unsigned long)busStats.maxCorrectionUs,
+                    (unsigned long)busStats.tokensGranted);
+    }
+
+    EyesFrameStats frames = eyes.takeFrameStats();
+    if (frames.activeUs > 0 && frames.frames > 0)
+    {
+      // Refresh rate achieved while gliding, and the CPU share it took
+      Serial.printf("[eyes] gliding %lu s at %lu Hz, %lu us per frame (%lu.%lu%% CPU), %lu rows sent\n",
+                    (unsigned long)(frames.activeUs / 1000000),
+                    (unsigned long)((uint64_t)frames.frames * 1000000 / frames.activeUs),
+                    (unsigned long)(frames.busyUs / frames.frames),
+                    (unsigned long)((uint64_t)frames.busyUs * 100 / frames.activeUs),
+                    (unsigned long)((uint64_t)frames.busyUs * 1000 / frames.activeUs % 10),
+                    (unsigned long)frames.rowsSent);
+    }
+    EyesModeStats modes = eyes.getModeStats();
+    Serial.printf("[eyes] mode requests queued %lu, preempted %lu, dropped %lu\n",
+                  (unsigned long)modes.queued, (unsigned long)modes.preempted,
+                  (unsigned long)modes.dropped);
+  }
+}
+
+/**
+ * Wait until the next loop iteration
+ *
+ * With LOW_POWER_LIGHT_SLEEP, the CPU is put in light sleep instead of
+ * spinning in delay(). The DFPlayer UART is flushed and its TX pin held
+ * before sleeping, and a DFPlayer message wakes the CPU up early. No sleep
+ * while a DFPlayer reply is expected, its first bytes would be lost, while
+ * a clip plays on the DAC or a WS2812 frame is being sent, for short waits
+ * (scene events) or while the serial console is in use. Never with the
+ * skull bus: UART2 cannot receive in light sleep.
+ *
+ * Waking up takes time (clocks, flash, restoring the peripherals): the
+ * timer fires LIGHT_SLEEP_WAKEUP_MARGIN early and the rest is spun, so that
+ * the next scene event is not late.
+ *
+ * Returns the time actually spent in light sleep (us)
+ */
+unsigned long idle(unsigned long us)
+{
+#if LOW_POWER_LIGHT_SLEEP
+  static_assert(LIGHT_SLEEP_MIN_TIME > LIGHT_SLEEP_WAKEUP_MARGIN, "Light sleep shorter than its wake up margin");
+  if (!sounds.canSleep() || !eyes.canSleep() || SKULL_BUS_ROLE != SKULL_BUS_OFF ||
+      us < LIGHT_SLEEP_MIN_TIME ||
+      (long)(consoleAwakeUntil - millis()) > 0)
+  {
+    delay(us / 1000);
+    delayMicroseconds(us % 1000);
+    return 0;
+  }
+
+  unsigned long start = micros();
+  Serial.flush(); // Console UART clock stops too
+  sounds.prepareSleep();
+  gpio_hold_en((gpio_num_t)CS_PIN); // No spurious latch on the MAX7219
+
+  // Typing on the console wakes the CPU up, the first characters are lost
+  uart_set_wakeup_threshold(UART_NUM_0, 3);
+  esp_sleep_enable_uart_wakeup(0);
+
+  // Flushing the console may have taken part of the wait
+  unsigned long slept = 0;
+  esp_sleep_wakeup_cause_t cause = ESP_SLEEP_WAKEUP_UNDEFINED;
+  unsigned long prepared = micros() - start;
+  if (prepared + LIGHT_SLEEP_WAKEUP_MARGIN < us)
+  {
+    esp_sleep_enable_timer_wakeup(us - LIGHT_SLEEP_WAKEUP_MARGIN - prepared);
+    unsigned long sleepStart = micros();
+    esp_light_sleep_start();
+    slept = micros() - sleepStart;
+    cause = esp_sleep_get_wakeup_cause();
+  }
+
+  gpio_hold_dis((gpio_num_t)CS_PIN);
+  sounds.resumeFromSleep();
+  if (cause == ESP_SLEEP_WAKEUP_UART)
+  {
+    consoleAwakeUntil = millis() + CONSOLE_AWAKE_TIME;
+    return slept; // Handle the message right away
+  }
+
+  // Spin what the early wake up left
+  long left = (long)(us - (micros() - start));
+  if (left > 0)
+  {
+    delayMicroseconds(left);
+  }
+  return slept;
+#else
+  delay(us / 1000);
+  delayMicroseconds(us % 1000);
+  return 0;
+#endif
 }
 
 void animateEyes()
 {
+  // A scrolling message owns the displays, the eyes come back when it is over.
+  // Intensity effects (a scene flash or breath) go on under the message
+  if (text.update())
+  {
+    eyes.updateIntensity();
+    return;
+  }
+
   // Update the display
   eyes.update();
 
@@ -102,63 +299,115 @@ void animateEyes()
     return; // Let animation finish
   }
 
-  // Marker for end of animation, start of new delay
-  if (lastAnimationEndTime == 0)
+  if (sceneActive)
   {
-    lastAnimationEndTime = millis();
-    if (currentMode == CLOSED)
+    if (choreography.isRunning())
     {
-      randomDelay = random(MIN_RANDOM_DELAY_CLOSED, MAX_RANDOM_DELAY_CLOSED);
+      return; // The scene drives the eyes
     }
-    else
+
+    // Scene over, give control back to the behavior engine
+    sceneActive = false;
+    if (brightnessOverride)
     {
-      randomDelay = random(MIN_RANDOM_DELAY, MAX_RANDOM_DELAY); // Initial random delay between 1 to 5 seconds
+      brightnessOverride = false;
+      eyes.setBrightness(autoBrightness());
     }
+    Serial.printf("[scene] done, max lateness %lu us\n", (unsigned long)choreography.takeMaxLateness());
+    lastAnimationEndTime = 0;
+    dwellTime = SCENE_RESUME_DELAY;
+    return;
+  }
+
+  // Marker for end of animation, start of the dwell time
+  if (lastAnimationEndTime == 0)
+  {
+    lastAnimationEndTime = millis();
   }
 
-  // Wait until delay expires
-  if (millis() - lastAnimationEndTime < randomDelay)
+  // Stay in the current state for its dwell time
+  if (millis() - lastAnimationEndTime < dwellTime)
   {
-    return; // Wait for delay to expire
+    return; // Wait for dwell time to expire
   }
 
   // If we reach here, we can start a new animation
   lastAnimationEndTime = 0;
 
-  // Decide next mode
-  if (currentMode == CLOSED)
+  // Let the behavior engine pick the next state
+  BehaviorDecision decision = behavior.next();
+  dwellTime = decision.dwellMs;
+
+  // Slow breathing glow while idle, steady otherwise. Decisions come faster
+  // than a breath: a running breath is left alone, restarting it would flip
+  // it back onto its falling slope every time
+  if (decision.state == BEHAVIOR_IDLE_GAZE || decision.state == BEHAVIOR_STARE)
   {
-    // If it was closed, open
-    currentMode = NORMAL;
+    if (eyes.getIntensityEffect() != INTENSITY_BREATHE)
+    {
+      eyes.breathe(BREATHING_MIN_LEVEL, 255, BREATHING_PERIOD);
+    }
   }
   else
   {
-    // Maybe close eyes, depending on probability
-    int action = random(0, 100);
-    if (action < CLOSED_MODE_PROBABILITY)
+    eyes.fadeTo(255, INTENSITY_FADE_TIME);
+  }
+
+  switch (decision.state)
+  {
+  case BEHAVIOR_BLINK:
+    currentMode = CLOSED;
+    break;
+  case BEHAVIOR_YAWN:
+    if (soundAllowed(true))
     {
-      currentMode = CLOSED;
-      maybePlaySound(true);
+      Scene yawn;
+      if (findScene("yawn", yawn))
+      {
+        startScene(yawn);
+        return;
+      }
     }
+    currentMode = CLOSED; // Too soon for a yawn sound, just close the eyes
+    break;
+  default:
+    currentMode = NORMAL;
+    break;
   }
   eyes.requestMode(currentMode);
 
-  if (currentMode == NORMAL)
+  if (currentMode == NORMAL && decision.position >= 0)
   {
-    // Pick a random position
-    EyePosition pos = static_cast<EyePosition>(random(0, sizeof(eyePositions) / sizeof(eyePositions[0])));
-    eyes.requestPosition(eyePositions[pos].x, eyePositions[pos].y);
+    const BehaviorPosition &pos = gazePositions[decision.position];
+    // The leader looks around with all the skulls, at the same time
+    if (decision.state != BEHAVIOR_LOOK_AROUND ||
+        !bus.broadcast(SKULL_BUS_GAZE, micros() + SKULL_BUS_LEAD * 1000UL, pos.x, pos.y))
+    {
+      eyes.requestPosition(pos.x, pos.y);
+    }
   }
 }
 
-void maybePlaySound(bool yawn)
+/**
+ * Check if a sound may be played now
+ *
+ * Yawns may come sooner than other sounds, but not before
+ * MIN_YAWNING_INTERVAL since the last sound.
+ */
+bool soundAllowed(bool yawn)
 {
+  if (bus.isActive())
+  {
+    // The leader paces the sounds of all skulls: speak only with the token
+    return bus.maySpeak() && !sounds.isPlaying();
+  }
+
   unsigned long now = millis();
   if (now - lastSoundTime < soundDelay)
   {
     if (!yawn)
     {
-      return; // Not time yet
+      return false; // Not time yet
     }
     else
     {
@@ -166,20 +415,251 @@ void maybePlaySound(bool yawn)
       // But only if minimum yawning interval has passed
       if (now - lastSoundTime < MIN_YAWNING_INTERVAL)
       {
-        return; // Not enough time since last sound, cancel yawn
+        return false; // Not enough time since last sound, cancel yawn
       }
     }
   }
+  return true;
+}
 
-  lastSoundTime = now;
-  if (yawn)
+void maybePlaySound(bool yawn)
+{
+  if (!soundAllowed(yawn))
   {
-    sounds.playYawningSound();
+    return;
   }
-  else
+
+  lastSoundTime = millis();
+  bool played = yawn ? sounds.playYawningSound() : sounds.playSpeechOrEffectSound();
+  if (!played)
   {
-    sounds.playSpeechOrEffectSound();
+    bus.releaseToken(); // Let another skull speak
   }
 
   soundDelay = random(MIN_SOUND_DELAY, MAX_SOUND_DELAY);
-}
\ No newline at end of file
+}
+
+void startScene(const Scene &scene)
+{
+  choreography.start(scene);
+  sceneActive = true;
+  Serial.printf("[scene] %s\n", scene.name);
+}
+
+/**
+ * Play a scene on request: on all skulls at once when leading the bus,
+ * voiced by the leader only, else on this skull right away
+ */
+void playScene(const Scene &scene)
+{
+  uint8_t index = sceneIndex(scene);
+  if (index < getSceneCount() &&
+      bus.broadcast(SKULL_BUS_SCENE, micros() + SKULL_BUS_LEAD * 1000UL, index, 0))
+  {
+    bus.claimToken();
+    return;
+  }
+  startScene(scene);
+}
+
+/**
+ * Schedule the group commands received on the bus at their shared time
+ */
+void applyBusCommands()
+{
+  SkullBusCommand command;
+  while (bus.takeCommand(command))
+  {
+    SceneEvent event = {0, SCENE_GAZE, command.a, command.b};
+    if (command.type == SKULL_BUS_SCENE)
+    {
+      event.type = SCENE_START;
+    }
+    choreography.schedule(event, command.dueUs);
+  }
+}
+
+/**
+ * Apply a scene event to the eyes and sounds
+ *
+ * Returns false for SCENE_WAIT_TRACK_END while the sound is playing
+ */
+bool onSceneEvent(const SceneEvent &event)
+{
+  switch (event.type)
+  {
+  case SCENE_PLAY_SOUND:
+    // On a bus, only the token holder speaks (the leader for group scenes)
+    if (bus.maySpeak() && sounds.playTrack(event.a, event.b))
+    {
+      // Scene sounds count for the random sounds pacing
+      lastSoundTime = millis();
+      soundDelay = random(MIN_SOUND_DELAY, MAX_SOUND_DELAY);
+    }
+    break;
+  case SCENE_GAZE:
+    eyes.requestPosition(event.a, event.b);
+    break;
+  case SCENE_MODE:
+    currentMode = (EyeMode)event.a;
+    eyes.requestMode(currentMode);
+    break;
+  case SCENE_BLINK:
+    // Reopens right after closing, even when asked mid-transition
+    eyes.requestMode(CLOSED);
+    eyes.queueMode(NORMAL);
+    currentMode = NORMAL;
+    break;
+  case SCENE_BRIGHTNESS:
+    brightnessOverride = (event.a != SCENE_BRIGHTNESS_AUTO);
+    eyes.setBrightness(brightnessOverride ? event.a : autoBrightness());
+    break;
+  case SCENE_WAIT_TRACK_END:
+    return !sounds.isPlaying();
+  case SCENE_FADE:
+    eyes.fadeTo(event.a, event.b * 50UL);
+    break;
+  case SCENE_BREATHE:
+    eyes.breathe(event.a, 255, event.b * 100UL);
+    break;
+  case SCENE_FLASH:
+    eyes.flash(event.b * 50UL);
+    break;
+  case SCENE_TEXT:
+  {
+    const char *message = getSceneMessage(event.a);
+    if (message != NULL)
+    {
+      text.start(message, event.b);
+    }
+    break;
+  }
+  case SCENE_START:
+  {
+    Scene scene;
+    if (getScene(event.a, scene))
+    {
+      startScene(scene);
+    }
+    break;
+  }
+  }
+  return true;
+}
+
+/**
+ * Map the asset pack and use what it has instead of the built-in assets
+ *
+ * Everything stays in flash: the eyes, text scroller and scenes keep
+ * pointers into the mapped partition. Sound folders go to the config passed
+ * to Sounds::begin().
+ */
+void loadAssets(SoundsConfig &config)
+{
+  if (!assets.begin())
+  {
+    Serial.println("[assets] no asset pack, using built-in assets");
+    return;
+  }
+
+  eyes.setShape(assets.eyeShape());
+
+  uint16_t positionCount = 0;
+  const AssetPosition *positions = assets.gazePositions(positionCount);
+  static_assert(sizeof(AssetPosition) == sizeof(BehaviorPosition), "BehaviorPosition layout");
+  if (positions != NULL && positionCount == GAZE_POSITION_COUNT)
+  {
+    gazePositions = (const BehaviorPosition *)positions;
+  }
+
+  const uint8_t *glyphs = NULL;
+  const AssetFont *font = assets.font(glyphs);
+  if (font != NULL)
+  {
+    text.setFont(glyphs, font->first, font->last, font->width);
+  }
+
+  const AssetSounds *folders = assets.sounds();
+  if (folders != NULL)
+  {
+    config.yawningFolder = folders->yawningFolder;
+    config.speechFolder = folders->speechFolder;
+    config.effectFolder = folders->effectFolder;
+    config.yawningNbSounds = folders->yawningNbSounds;
+    config.speechNbSounds = folders->speechNbSounds;
+    config.effectNbSounds = folders->effectNbSounds;
+  }
+
+  useSceneAssets(assets);
+
+  Serial.printf("[assets] pack loaded: shape %s, positions %s, font %s, sounds %s, %u scenes\n",
+                assets.eyeShape() ? "yes" : "no", gazePositions != behaviorPositions ? "yes" : "no",
+                font ? "yes" : "no", folders ? "yes" : "no", (unsigned)getSceneCount());
+}
+
+/**
+ * Brightness when no scene overrides it
+ */
+uint8_t autoBrightness()
+{
+  return ambientLightAvailable ? ambientLight.getLevel() : EYES_BRIGHTNESS;
+}
+
+/**
+ * Read serial console commands, never blocks
+ *
+ * - scene <name>: play a scene
+ * - stop: stop the scene in progress
+ * - say <text>: scroll a message across the eyes
+ */
+void handleSerial()
+{
+  static char line[TEXT_MAX_LENGTH + 8];
+  static uint8_t length = 0;
+
+  while (Serial.available())
+  {
+    char c = Serial.read();
+    consoleAwakeUntil = millis() + CONSOLE_AWAKE_TIME;
+    if (c != '\n' && c != '\r')
+    {
+      if (length < sizeof(line) - 1)
+      {
+        line[length++] = c;
+      }
+      continue;
+    }
+    if (length == 0)
+    {
+      continue;
+    }
+    line[length] = '\0';
+    length = 0;
+
+    if (strncmp(line, "scene ", 6) == 0)
+    {
+      Scene scene;
+      if (findScene(line + 6, scene))
+      {
+        playScene(scene);
+      }
+      else
+      {
+        Serial.printf("Unknown scene: %s\n", line + 6);
+      }
+    }
+    else if (strcmp(line, "stop") == 0)
+    {
+      choreography.stop();
+      text.stop();
+    }
+    else if (strncmp(line, "say ", 4) == 0)
+    {
+      text.start(line + 4);
+    }
+    else
+    {
+      Serial.println("Commands: scene <yawn|scare|lookaround|boo|halloween>, say <text>, stop");
+    }
+  }
+}
@@ -0,0 +1,151 @@
+#include <Eyes.h>
+#include "scenes.h"
+#include "config.h"
+
+#define SCENE(name, events) {name, events, sizeof(events) / sizeof(events[0])}
+
+static const char *const builtinMessages[] = {
+    "BOO",
+    "HAPPY HALLOWEEN",
+};
+static const uint8_t builtinMessageCount = sizeof(builtinMessages) / sizeof(builtinMessages[0]);
+
+// {atMs, type, a, b}
+static const SceneEvent yawnEvents[] = {
+    {0, SCENE_MODE, CLOSED, 0},
+    {0, SCENE_FADE, 0, 6},                      // Fade out while closing
+    {300, SCENE_PLAY_SOUND, YAWNING_FOLDER, 0}, // Eyes are closed after 4 steps of 75ms
+    {300, SCENE_WAIT_TRACK_END, 0, 15},
+    {800, SCENE_MODE, NORMAL, 0},               // Open 500ms after the yawn
+    {800, SCENE_FADE, 255, 8},
+};
+
+static const SceneEvent scareEvents[] = {
+    {0, SCENE_GAZE, 3, 3},
+    {0, SCENE_BRIGHTNESS, 15, 0},
+    {50, SCENE_PLAY_SOUND, EFFECT_FOLDER, 0},
+    {50, SCENE_FLASH, 0, 10},
+    {600, SCENE_BLINK, 0, 0},
+    {1500, SCENE_BRIGHTNESS, SCENE_BRIGHTNESS_AUTO, 0},
+};
+
+static const SceneEvent lookAroundEvents[] = {
+    {0, SCENE_GAZE, 0, 3},
+    {700, SCENE_GAZE, 6, 3},
+    {1400, SCENE_GAZE, 0, 3},
+    {2100, SCENE_GAZE, 3, 3},
+    {2400, SCENE_PLAY_SOUND, SPEECH_FOLDER, 0},
+    {2400, SCENE_WAIT_TRACK_END, 0, 15},
+    {2700, SCENE_BLINK, 0, 0},
+};
+
+static const SceneEvent booEvents[] = {
+    {0, SCENE_BRIGHTNESS, 15, 0},
+    {0, SCENE_TEXT, 0, 40},
+    {0, SCENE_PLAY_SOUND, EFFECT_FOLDER, 0},
+    {200, SCENE_FLASH, 0, 10},
+    {1500, SCENE_BRIGHTNESS, SCENE_BRIGHTNESS_AUTO, 0},
+};
+
+static const SceneEvent halloweenEvents[] = {
+    {0, SCENE_TEXT, 1, 0},
+    {0, SCENE_BREATHE, 128, 20},
+};
+
+static const Scene builtinScenes[] = {
+    SCENE("yawn", yawnEvents),             // Close the eyes, yawn, open them when the yawn is over
+    SCENE("scare", scareEvents),           // Stare, flash and play an effect
+    SCENE("lookaround", lookAroundEvents), // Look left and right, then talk
+    SCENE("boo", booEvents),               // Scroll "BOO" with an effect
+    SCENE("halloween", halloweenEvents),   // Scroll "HAPPY HALLOWEEN"
+};
+static const uint8_t builtinSceneCount = sizeof(builtinScenes) / sizeof(builtinScenes[0]);
+
+// Pack events are handed to the choreography as they are
+static_assert(sizeof(SceneEvent) == sizeof(AssetSceneEvent), "SceneEvent layout");
+static_assert(offsetof(SceneEvent, type) == offsetof(AssetSceneEvent, type), "SceneEvent layout");
+static_assert(offsetof(SceneEvent, b) == offsetof(AssetSceneEvent, b), "SceneEvent layout");
+
+// Asset pack scenes and messages, when loaded
+static const AssetScene *packScenes = NULL;
+static const AssetSceneEvent *packEvents = NULL;
+static uint16_t packSceneCount = 0;
+static const char *packMessages = NULL;
+static uint16_t packMessageCount = 0;
+
+void useSceneAssets(const AssetPackReader &assets)
+{
+  packScenes = assets.scenes(packSceneCount, packEvents);
+  packMessages = assets.messages(packMessageCount);
+}
+
+uint8_t getSceneCount()
+{
+  if (packScenes != NULL)
+  {
+    return (uint8_t)min(packSceneCount, (uint16_t)UINT8_MAX);
+  }
+  return builtinSceneCount;
+}
+
+bool getScene(uint8_t index, Scene &scene)
+{
+  if (index >= getSceneCount())
+  {
+    return false;
+  }
+  if (packScenes == NULL)
+  {
+    scene = builtinScenes[index];
+    return true;
+  }
+  const AssetScene &entry = packScenes[index];
+  scene.name = entry.name;
+  scene.events = (const SceneEvent *)&packEvents[entry.firstEvent];
+  scene.count = entry.eventCount;
+  return true;
+}
+
+bool findScene(const char *name, Scene &scene)
+{
+  for (uint8_t i = 0; i < getSceneCount(); i++)
+  {
+    if (getScene(i, scene) && strcmp(scene.name, name) == 0)
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+uint8_t sceneIndex(const Scene &scene)
+{
+  Scene candidate;
+  for (uint8_t i = 0; i < getSceneCount(); i++)
+  {
+    if (getScene(i, candidate) && candidate.events == scene.events)
+    {
+      return i;
+    }
+  }
+  return getSceneCount();
+}
+
+const char *getSceneMessage(uint8_t index)
+{
+  if (packMessages == NULL)
+  {
+    return index < builtinMessageCount ? builtinMessages[index] : NULL;
+  }
+  if (index >= packMessageCount)
+  {
+    return NULL;
+  }
+  // Messages follow each other's terminator
+  const char *message = packMessages;
+  for (uint8_t i = 0; i < index; i++)
+  {
+    message += strlen(message) + 1;
+  }
+  return message;
+}
@@ -0,0 +1,48 @@
+#ifndef SCENES_H
+#define SCENES_H
+
+#include <Choreography.h>
+#include <AssetPackFormat.h>
+
+/**
+ * Use the scenes and messages of an asset pack instead of the built-in ones
+ *
+ * Each of them is replaced as a whole, when the pack has it. Pack scenes are
+ * played in place from flash.
+ */
+void useSceneAssets(const AssetPackReader &assets);
+
+/**
+ * Get the number of scenes
+ */
+uint8_t getSceneCount();
+
+/**
+ * Get a scene by index, e.g. for SCENE_START and the skull bus
+ *
+ * Returns false if there is no scene at this index
+ */
+bool getScene(uint8_t index, Scene &scene);
+
+/**
+ * Find a scene by name
+ *
+ * Returns false if there is none with this name
+ */
+bool findScene(const char *name, Scene &scene);
+
+/**
+ * Get the index of a scene
+ *
+ * Returns getSceneCount() if it is not there
+ */
+uint8_t sceneIndex(const Scene &scene);
+
+/**
+ * Get a message of the SCENE_TEXT events
+ *
+ * Returns NULL if there is no message at this index
+ */
+const char *getSceneMessage(uint8_t index);
+
+#endif // SCENES_H
@@ -0,0 +1,155 @@
+// ImaAdpcmDecoder on the host, against the encoder and reference decoder of
+// tools/audio_pack.py
+//
+// pio test -e native -f test_ima_adpcm (from the project directory, python3
+// in the PATH)
+
+#include <unity.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <math.h>
+#include <ImaAdpcm.h>
+
+#define CLIP_SAMPLES 4000 // Not a whole number of blocks
+#define MAX_ENCODED 8192
+
+// Encode the clip, then write its size, the blocks and the reference decode
+static const char *PACK_SCRIPT =
+    "import struct, sys\n"
+    "sys.path.insert(0, 'tools')\n"
+    "import audio_pack\n"
+    "raw = open(sys.argv[1], 'rb').read()\n"
+    "pcm = list(struct.unpack('<%dh' % (len(raw) // 2), raw))\n"
+    "block_size = int(sys.argv[2])\n"
+    "data = audio_pack.encode(pcm, block_size)\n"
+    "ref = audio_pack.decode(data, len(pcm), block_size)\n"
+    "out = sys.stdout.buffer\n"
+    "out.write(struct.pack('<I', len(data)) + data)\n"
+    "out.write(struct.pack('<%dh' % len(ref), *ref))\n";
+
+static int16_t clip[CLIP_SAMPLES];
+static uint8_t encoded[MAX_ENCODED];
+static uint32_t encodedSize;
+static int16_t reference[CLIP_SAMPLES];
+static int16_t decoded[CLIP_SAMPLES + 1];
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+// Sine sweep, full scale steps (step index and predictor clamps), then noise
+static void buildClip()
+{
+    uint32_t seed = 12345;
+    for (uint32_t i = 0; i < CLIP_SAMPLES; i++)
+    {
+        if (i < 1500)
+        {
+            clip[i] = (int16_t)(12000 * sin(i * (0.01 + i * 0.0002)));
+        }
+        else if (i < 2500)
+        {
+            clip[i] = ((i / 100) & 1) ? 32767 : -32768;
+        }
+        else
+        {
+            seed = seed * 1103515245 + 12345;
+            clip[i] = (int16_t)(seed >> 16) / 4;
+        }
+    }
+}
+
+static void packClip(uint16_t blockSize)
+{
+    char pcmPath[] = "/tmp/ima_adpcm_XXXXXX";
+    int fd = mkstemp(pcmPath);
+    TEST_ASSERT_TRUE(fd >= 0);
+    TEST_ASSERT_EQUAL(sizeof(clip), write(fd, clip, sizeof(clip)));
+    close(fd);
+
+    char scriptPath[] = "/tmp/ima_adpcm_XXXXXX.py";
+    fd = mkstemps(scriptPath, 3);
+    TEST_ASSERT_TRUE(fd >= 0);
+    TEST_ASSERT_EQUAL(strlen(PACK_SCRIPT), write(fd, PACK_SCRIPT, strlen(PACK_SCRIPT)));
+    close(fd);
+
+    char command[128];
+    snprintf(command, sizeof(command), "python3 %s %s %u", scriptPath, pcmPath, blockSize);
+    FILE *pack = popen(command, "r");
+    TEST_ASSERT_NOT_NULL(pack);
+    TEST_ASSERT_EQUAL(1, fread(&encodedSize, sizeof(encodedSize), 1, pack));
+    TEST_ASSERT_TRUE(encodedSize <= MAX_ENCODED);
+    TEST_ASSERT_EQUAL(encodedSize, fread(encoded, 1, encodedSize, pack));
+    TEST_ASSERT_EQUAL(CLIP_SAMPLES, fread(reference, sizeof(int16_t), CLIP_SAMPLES, pack));
+    TEST_ASSERT_EQUAL_MESSAGE(0, pclose(pack), "tools/audio_pack.py failed");
+    unlink(pcmPath);
+    unlink(scriptPath);
+}
+
+// Decode the whole clip, reads of odd sizes crossing nibbles and blocks
+static void assertDecodesLikeReference(uint16_t blockSize)
+{
+    static const size_t READS[] = {1, 7, 13, 257, 3, 505, 2, 1000};
+
+    buildClip();
+    packClip(blockSize);
+    uint32_t blocks = (CLIP_SAMPLES + imaAdpcmSamplesPerBlock(blockSize) - 1) / imaAdpcmSamplesPerBlock(blockSize);
+    TEST_ASSERT_EQUAL_UINT32(blocks * blockSize, encodedSize);
+
+    ImaAdpcmDecoder decoder;
+    decoder.begin(encoded, CLIP_SAMPLES, blockSize);
+    uint32_t total = 0;
+    for (uint8_t i = 0; decoder.remaining() > 0; i = (i + 1) % (sizeof(READS) / sizeof(READS[0])))
+    {
+        size_t wanted = READS[i];
+        size_t left = CLIP_SAMPLES - total;
+        size_t count = decoder.read(&decoded[total], wanted);
+        TEST_ASSERT_EQUAL(wanted < left ? wanted : left, count);
+        total += count;
+        TEST_ASSERT_EQUAL_UINT32(CLIP_SAMPLES - total, decoder.remaining());
+    }
+    TEST_ASSERT_EQUAL_UINT32(CLIP_SAMPLES, total);
+    TEST_ASSERT_EQUAL(0, decoder.read(&decoded[total], 1));
+
+    for (uint32_t i = 0; i < CLIP_SAMPLES; i++)
+    {
+        char message[32];
+        snprintf(message, sizeof(message), "sample %u", (unsigned)i);
+        TEST_ASSERT_EQUAL_INT16_MESSAGE(reference[i], decoded[i], message);
+    }
+}
+
+void test_decode_block_256()
+{
+    assertDecodesLikeReference(256);
+}
+
+void test_decode_block_1024()
+{
+    assertDecodesLikeReference(1024);
+}
+
+void test_decode_follows_clip()
+{
+    // The sweep comes back close to the original
+    assertDecodesLikeReference(256);
+    for (uint32_t i = 0; i < 1500; i++)
+    {
+        TEST_ASSERT_INT16_WITHIN(2000, clip[i], decoded[i]);
+    }
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_decode_block_256);
+    RUN_TEST(test_decode_block_1024);
+    RUN_TEST(test_decode_follows_clip);
+    return UNITY_END();
+}
@@ -0,0 +1,450 @@
+// SkullBus on the host: one leader and two followers, each on its own
+// pseudo-terminal, joined by a hub playing the shared RS-485 line
+//
+// pio test -e native -f test_skull_bus
+
+#include <unity.h>
+#include <pty.h>
+#include <termios.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <string.h>
+#include <SkullBus.h>
+
+#define SKULLS 3
+#define TICK_US 200               // Simulation step
+#define BAUD_RATE 115200
+#define BYTE_US (10 * 1000000UL / BAUD_RATE)
+#define LEADER_TIMEOUT_US 3500000 // SkullBus::LEADER_TIMEOUT
+#define SPEECH_US 400000          // Length of the sounds played with the token
+#define HUB_CAPACITY 1024
+
+static const SkullBusConfig config = {
+    .skullCount = SKULLS,
+    .baudRate = BAUD_RATE,
+    .slotMs = 2000,
+    .tokenGapMinMs = 300,
+    .tokenGapMaxMs = 800,
+};
+
+/**
+ * Skull end of a pseudo-terminal, in raw mode, as a UART would be
+ */
+class PtyPort : public SkullBusPort
+{
+public:
+    int master = -1;
+    int slave = -1;
+    uint32_t written = 0;  // Bytes written by the skull
+    uint32_t consumed = 0; // Bytes read by the skull
+
+    void open()
+    {
+        TEST_ASSERT_EQUAL(0, openpty(&master, &slave, NULL, NULL, NULL));
+        struct termios raw;
+        tcgetattr(slave, &raw);
+        cfmakeraw(&raw); // No echo, no line editing
+        tcsetattr(slave, TCSANOW, &raw);
+        fcntl(master, F_SETFL, fcntl(master, F_GETFL) | O_NONBLOCK);
+        fcntl(slave, F_SETFL, fcntl(slave, F_GETFL) | O_NONBLOCK);
+    }
+
+    void close()
+    {
+        ::close(master);
+        ::close(slave);
+    }
+
+    int read() override
+    {
+        uint8_t byte;
+        if (::read(slave, &byte, 1) != 1)
+        {
+            return -1;
+        }
+        consumed++;
+        return byte;
+    }
+
+    void write(const uint8_t *data, uint8_t length) override
+    {
+        TEST_ASSERT_EQUAL(length, ::write(slave, data, length));
+        written += length;
+    }
+};
+
+struct Skull
+{
+    PtyPort port;
+    SkullBus *bus;
+    uint32_t clockOffset; // Local clock at time 0
+    int32_t driftPpm;
+    uint32_t loopUs;      // Mean time between two update() calls
+    uint32_t nextLoopUs;
+    uint32_t jitterSeed;
+    bool connected;
+    uint32_t speakingUntil;
+    uint32_t slotsUsed;   // Sounds played with the token
+    uint32_t delivered;   // Bytes the hub wrote to this skull
+
+    uint32_t clock(uint32_t t)
+    {
+        return clockOffset + t + (uint32_t)((int64_t)t * driftPpm / 1000000);
+    }
+
+    // Loops take more or less time with the work they do: 0.5 to 1.5 loopUs
+    uint32_t nextLoop()
+    {
+        jitterSeed ^= jitterSeed << 13;
+        jitterSeed ^= jitterSeed >> 17;
+        jitterSeed ^= jitterSeed << 5;
+        return loopUs / 2 + jitterSeed % loopUs;
+    }
+};
+
+/**
+ * A byte on the line, sent by one skull, heard by the others
+ */
+struct LineByte
+{
+    uint32_t arrivalUs;
+    uint8_t from;
+    uint8_t value;
+};
+
+static Skull skulls[SKULLS];
+static LineByte line[HUB_CAPACITY];
+static uint16_t lineCount;
+static uint32_t lineFreeUs; // Half-duplex: one byte after the other
+static uint32_t collected[SKULLS];
+static uint32_t leaderBytes;  // Bytes of the leader put on the line
+static uint8_t leaderType;    // Type of the leader frame on the line
+static uint32_t lastBeaconUs; // Arrival of the last beacon
+static uint32_t nowUs;
+static uint8_t maxSpeakers;
+
+void setUp()
+{
+    // Leader, then two followers with their own clocks, the last one wraps
+    const uint32_t offsets[SKULLS] = {12345678, 0x7FFF0000, 0xFFE00000};
+    const int32_t drifts[SKULLS] = {0, 30, -25};
+    const uint32_t loops[SKULLS] = {5000, 7000, 11000};
+    for (uint8_t i = 0; i < SKULLS; i++)
+    {
+        Skull &skull = skulls[i];
+        skull.port.written = 0;
+        skull.port.consumed = 0;
+        skull.port.open();
+        skull.clockOffset = offsets[i];
+        skull.driftPpm = drifts[i];
+        skull.loopUs = loops[i];
+        skull.nextLoopUs = 0;
+        skull.jitterSeed = 0x9E3779B9 + i;
+        skull.connected = true;
+        skull.speakingUntil = 0;
+        skull.slotsUsed = 0;
+        skull.delivered = 0;
+        skull.bus = new SkullBus(skull.port);
+        skull.bus->begin(i == 0 ? SKULL_BUS_LEADER : SKULL_BUS_FOLLOWER, i, config, skull.clock(0));
+        collected[i] = 0;
+    }
+    lineCount = 0;
+    lineFreeUs = 0;
+    leaderBytes = 0;
+    leaderType = 0;
+    lastBeaconUs = 0;
+    nowUs = 0;
+    maxSpeakers = 0;
+}
+
+void tearDown()
+{
+    for (uint8_t i = 0; i < SKULLS; i++)
+    {
+        delete skulls[i].bus;
+        skulls[i].port.close();
+    }
+}
+
+// Block until a file descriptor has at least count bytes to read: pty
+// transfers go through a kernel work queue
+static void waitReadable(int fd, uint32_t count)
+{
+    for (int tries = 0; tries < 1000; tries++)
+    {
+        int available = 0;
+        ioctl(fd, FIONREAD, &available);
+        if ((uint32_t)available >= count)
+        {
+            return;
+        }
+        // poll() would return at once with a partial transfer pending
+        usleep(1000);
+    }
+    TEST_FAIL_MESSAGE("pty transfer timed out");
+}
+
+// Put the bytes the skulls wrote on the line, hand over those that arrived
+static void pumpHub()
+{
+    for (uint8_t i = 0; i < SKULLS; i++)
+    {
+        Skull &skull = skulls[i];
+        if (collected[i] < skull.port.written)
+        {
+            waitReadable(skull.port.master, skull.port.written - collected[i]);
+        }
+        uint8_t byte;
+        while (::read(skull.port.master, &byte, 1) == 1)
+        {
+            collected[i]++;
+            if (!skull.connected)
+            {
+                continue; // Cut off the bus
+            }
+            TEST_ASSERT_TRUE(lineCount < HUB_CAPACITY);
+            lineFreeUs = (lineFreeUs > nowUs ? lineFreeUs : nowUs) + BYTE_US;
+            line[lineCount++] = {lineFreeUs, i, byte};
+            if (i == SKULL_BUS_LEADER_ID)
+            {
+                // The leader only writes whole frames
+                uint8_t index = leaderBytes++ % SKULL_BUS_FRAME_SIZE;
+                leaderType = index == 1 ? byte : leaderType;
+                if (index == SKULL_BUS_FRAME_SIZE - 1 && leaderType == SKULL_BUS_BEACON)
+                {
+                    lastBeaconUs = lineFreeUs;
+                }
+            }
+        }
+    }
+
+    uint16_t kept = 0;
+    for (uint16_t n = 0; n < lineCount; n++)
+    {
+        if ((int32_t)(line[n].arrivalUs - nowUs) > 0)
+        {
+            line[kept++] = line[n];
+            continue;
+        }
+        for (uint8_t i = 0; i < SKULLS; i++)
+        {
+            // With DE driving /RE, a transceiver does not hear itself
+            if (i != line[n].from && skulls[i].connected)
+            {
+                TEST_ASSERT_EQUAL(1, ::write(skulls[i].port.master, &line[n].value, 1));
+                skulls[i].delivered++;
+            }
+        }
+    }
+    lineCount = kept;
+
+    for (uint8_t i = 0; i < SKULLS; i++)
+    {
+        if (skulls[i].delivered > skulls[i].port.consumed)
+        {
+            waitReadable(skulls[i].port.slave, skulls[i].delivered - skulls[i].port.consumed);
+        }
+    }
+}
+
+typedef void (*CommandObserver)(uint8_t skull, const SkullBusCommand &command);
+
+// Run the skulls, speaking whenever they may and checking the token
+static void run(uint32_t durationUs, CommandObserver observer = NULL)
+{
+    uint32_t endUs = nowUs + durationUs;
+    for (; nowUs < endUs; nowUs += TICK_US)
+    {
+        pumpHub();
+
+        uint8_t speakers = 0;
+        for (uint8_t i = 0; i < SKULLS; i++)
+        {
+            Skull &skull = skulls[i];
+            if (!skull.connected)
+            {
+                continue;
+            }
+            if (nowUs >= skull.nextLoopUs)
+            {
+                skull.nextLoopUs = nowUs + skull.nextLoop();
+                bool speaking = nowUs < skull.speakingUntil;
+                skull.bus->update(skull.clock(nowUs), speaking);
+
+                if (!speaking && skull.bus->isActive() && skull.bus->maySpeak())
+                {
+                    // Speak once per slot: the token goes back when it ends
+                    skull.speakingUntil = nowUs + SPEECH_US;
+                    skull.slotsUsed++;
+                }
+
+                SkullBusCommand command;
+                while (skull.bus->takeCommand(command))
+                {
+                    if (observer != NULL)
+                    {
+                        observer(i, command);
+                    }
+                }
+            }
+            if (skull.bus->isActive() && nowUs < skull.speakingUntil)
+            {
+                speakers++;
+            }
+        }
+        maxSpeakers = speakers > maxSpeakers ? speakers : maxSpeakers;
+    }
+}
+
+// Leader clock error of a follower, as it would convert it (us)
+static int32_t clockError(uint8_t follower)
+{
+    uint32_t leaderUs = skulls[0].clock(nowUs);
+    return (int32_t)(skulls[follower].bus->toLocal(leaderUs) - skulls[follower].clock(nowUs));
+}
+
+// Beacons are read up to 1.5 loop periods late, the least delayed of a window
+// of SYNC_WINDOW is kept: a few tenths of a loop, plus the drift in between
+static int32_t syncTolerance(uint8_t follower)
+{
+    return skulls[follower].loopUs / 4;
+}
+
+void test_clock_offset_converges()
+{
+    run(1500000);
+    for (uint8_t i = 1; i < SKULLS; i++)
+    {
+        TEST_ASSERT_TRUE(skulls[i].bus->isActive());
+    }
+
+    // After a few correction windows, despite the drift and the loop delays
+    for (uint8_t second = 0; second < 40; second++)
+    {
+        run(1000000);
+        if (second < 20)
+        {
+            continue;
+        }
+        for (uint8_t i = 1; i < SKULLS; i++)
+        {
+            TEST_ASSERT_INT32_WITHIN(syncTolerance(i), 0, clockError(i));
+        }
+    }
+    for (uint8_t i = 1; i < SKULLS; i++)
+    {
+        SkullBusStats stats = skulls[i].bus->getStats();
+        TEST_ASSERT_GREATER_THAN_UINT32(0, stats.maxCorrectionUs);
+        TEST_ASSERT_EQUAL_UINT32(0, stats.framesDropped);
+    }
+}
+
+static uint32_t appliedAt[SKULLS][2]; // Simulation time of the GAZE and SCENE commands
+static uint8_t appliedCount[SKULLS];
+static SkullBusCommand pending[SKULLS][2];
+
+static void keepCommand(uint8_t skull, const SkullBusCommand &command)
+{
+    TEST_ASSERT_TRUE(appliedCount[skull] < 2);
+    pending[skull][appliedCount[skull]++] = command;
+}
+
+void test_commands_apply_at_the_same_time()
+{
+    run(20000000);
+
+    memset(appliedCount, 0, sizeof(appliedCount));
+    uint32_t leaderUs = skulls[0].clock(nowUs);
+    TEST_ASSERT_TRUE(skulls[0].bus->broadcast(SKULL_BUS_GAZE, leaderUs + 200000, 3, 4));
+    TEST_ASSERT_TRUE(skulls[0].bus->broadcast(SKULL_BUS_SCENE, leaderUs + 300000, 2, 0));
+    TEST_ASSERT_FALSE(skulls[1].bus->broadcast(SKULL_BUS_GAZE, leaderUs, 0, 0));
+    run(100000, keepCommand);
+
+    for (uint8_t i = 0; i < SKULLS; i++)
+    {
+        TEST_ASSERT_EQUAL(2, appliedCount[i]);
+        TEST_ASSERT_EQUAL(SKULL_BUS_GAZE, pending[i][0].type);
+        TEST_ASSERT_EQUAL(3, pending[i][0].a);
+        TEST_ASSERT_EQUAL(4, pending[i][0].b);
+        TEST_ASSERT_EQUAL(SKULL_BUS_SCENE, pending[i][1].type);
+        TEST_ASSERT_EQUAL(2, pending[i][1].a);
+    }
+
+    // Apply them when their local due time comes
+    bool applied[SKULLS][2] = {};
+    for (uint32_t end = nowUs + 400000; nowUs < end; nowUs += TICK_US)
+    {
+        for (uint8_t i = 0; i < SKULLS; i++)
+        {
+            for (uint8_t c = 0; c < 2; c++)
+            {
+                if (!applied[i][c] && (int32_t)(skulls[i].clock(nowUs) - pending[i][c].dueUs) >= 0)
+                {
+                    applied[i][c] = true;
+                    appliedAt[i][c] = nowUs;
+                }
+            }
+        }
+    }
+    for (uint8_t i = 0; i < SKULLS; i++)
+    {
+        for (uint8_t c = 0; c < 2; c++)
+        {
+            TEST_ASSERT_TRUE(applied[i][c]);
+            TEST_ASSERT_INT32_WITHIN(syncTolerance(i) + TICK_US, appliedAt[0][c], appliedAt[i][c]);
+        }
+    }
+}
+
+void test_one_speaker_at_a_time()
+{
+    run(60000000);
+
+    TEST_ASSERT_EQUAL(1, maxSpeakers);
+    for (uint8_t i = 0; i < SKULLS; i++)
+    {
+        // Every skull gets its turn
+        TEST_ASSERT_GREATER_THAN_UINT32(3, skulls[i].slotsUsed);
+    }
+    TEST_ASSERT_GREATER_THAN_UINT32(3 * SKULLS, skulls[0].bus->getStats().tokensGranted);
+}
+
+void test_follower_standalone_after_leader_timeout()
+{
+    run(10000000);
+    for (uint8_t i = 1; i < SKULLS; i++)
+    {
+        TEST_ASSERT_TRUE(skulls[i].bus->isActive());
+    }
+
+    // The leader goes silent, followers time out from the last beacon heard
+    skulls[0].connected = false;
+    uint32_t beaconUs = lastBeaconUs;
+
+    run(beaconUs + LEADER_TIMEOUT_US - 50000 - nowUs);
+    for (uint8_t i = 1; i < SKULLS; i++)
+    {
+        TEST_ASSERT_TRUE(skulls[i].bus->isActive());
+        TEST_ASSERT_EQUAL_UINT32(0, skulls[i].bus->getStats().leaderLost);
+    }
+
+    // A loop to notice it, another one for the beacon read late: 1.5 loopUs each
+    run(50000 + 3 * skulls[2].loopUs + TICK_US);
+    for (uint8_t i = 1; i < SKULLS; i++)
+    {
+        TEST_ASSERT_FALSE(skulls[i].bus->isActive());
+        TEST_ASSERT_TRUE(skulls[i].bus->maySpeak());
+        TEST_ASSERT_EQUAL_UINT32(1, skulls[i].bus->getStats().leaderLost);
+    }
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_clock_offset_converges);
+    RUN_TEST(test_commands_apply_at_the_same_time);
+    RUN_TEST(test_one_speaker_at_a_time);
+    RUN_TEST(test_follower_standalone_after_leader_timeout);
+    return UNITY_END();
+}
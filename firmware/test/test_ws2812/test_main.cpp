@@ -0,0 +1,202 @@
+// Ws2812Encoder on the host: rendering and RMT symbol buffers
+//
+// pio test -e native -f test_ws2812
+
+#include <unity.h>
+#include <string.h>
+#include <Ws2812Encoder.h>
+
+static const Ws2812Timing timing = WS2812_TIMING;
+static const uint8_t blankRows[8] = {0};
+
+static uint16_t gamma[256];
+static uint8_t identity[256];
+static uint8_t grb[WS2812_FRAME_BYTES];
+static uint32_t symbols[WS2812_FRAME_SYMBOLS];
+
+void setUp()
+{
+    ws2812BuildGamma(2.2f, gamma);
+    for (uint16_t i = 0; i < 256; i++)
+    {
+        identity[i] = i;
+    }
+    memset(grb, 0xAA, sizeof(grb));
+    memset(symbols, 0xAA, sizeof(symbols));
+}
+
+void tearDown()
+{
+}
+
+// Check the 8 symbols of a byte: MSB first, T1H/T1L for ones, T0H/T0L for zeros
+static void assertByteSymbols(const uint32_t *bits, uint8_t value)
+{
+    for (uint8_t i = 0; i < 8; i++)
+    {
+        bool one = value & (0x80 >> i);
+        uint32_t symbol = bits[i];
+        TEST_ASSERT_EQUAL_UINT32_MESSAGE(one ? timing.t1h : timing.t0h, symbol & 0x7FFF, "high time");
+        TEST_ASSERT_EQUAL_UINT32_MESSAGE(1, (symbol >> 15) & 1, "level0");
+        TEST_ASSERT_EQUAL_UINT32_MESSAGE(one ? timing.t1l : timing.t0l, (symbol >> 16) & 0x7FFF, "low time");
+        TEST_ASSERT_EQUAL_UINT32_MESSAGE(0, symbol >> 31, "level1");
+    }
+}
+
+static void assertResetSymbol(uint32_t symbol)
+{
+    TEST_ASSERT_EQUAL_UINT32(timing.reset / 2, symbol & 0x7FFF);
+    TEST_ASSERT_EQUAL_UINT32(0, (symbol >> 15) & 1);
+    TEST_ASSERT_EQUAL_UINT32(timing.reset / 2, (symbol >> 16) & 0x7FFF);
+    TEST_ASSERT_EQUAL_UINT32(0, symbol >> 31);
+}
+
+void test_symbol_layout()
+{
+    TEST_ASSERT_EQUAL_HEX32(0x00088004, ws2812Symbol(4, 8));
+    TEST_ASSERT_EQUAL_HEX32(0x00048008, ws2812Symbol(8, 4));
+}
+
+void test_encode_msb_first_then_reset()
+{
+    const uint8_t data[] = {0xA5, 0x00, 0xFF, 0x01};
+    size_t count = ws2812Encode(data, sizeof(data), timing, symbols);
+
+    TEST_ASSERT_EQUAL(sizeof(data) * 8 + 1, count);
+    for (uint8_t i = 0; i < sizeof(data); i++)
+    {
+        assertByteSymbols(&symbols[8 * i], data[i]);
+    }
+    assertResetSymbol(symbols[count - 1]);
+}
+
+void test_lut_follows_intensity()
+{
+    uint8_t lut[256];
+
+    // Duty (2 * intensity + 1) / 32 of the gamma corrected level
+    ws2812BuildLut(gamma, 15, lut);
+    TEST_ASSERT_EQUAL_UINT8(0, lut[0]);
+    TEST_ASSERT_EQUAL_UINT8(248, lut[255]);
+
+    ws2812BuildLut(gamma, 0, lut);
+    TEST_ASSERT_EQUAL_UINT8(0, lut[0]);
+    TEST_ASSERT_EQUAL_UINT8(8, lut[255]);
+    for (uint16_t i = 1; i < 256; i++)
+    {
+        TEST_ASSERT_TRUE(lut[i] >= lut[i - 1]);
+    }
+}
+
+void test_render_layers_grb()
+{
+    // x = 2: the iris leaves y = 1 off, the lids cover y = 6-7
+    uint8_t lit[8] = {0};
+    uint8_t shape[8] = {0};
+    lit[2] = 0x80 | 0x20; // y = 0 and y = 2
+    shape[2] = 0xFF;      // Whole column is eye
+    EyesFrame frame = {blankRows, lit, shape, 0xFC};
+    Ws2812Palette palette = {{10, 20, 30}, {40, 50, 60}, {70, 80, 90}};
+
+    ws2812Render(frame, palette, identity, false, grb);
+
+    // Right eye panel first, row by row: pixel = y * 8 + x
+    const uint8_t sclera[3] = {20, 10, 30};
+    const uint8_t iris[3] = {50, 40, 60};
+    const uint8_t lid[3] = {80, 70, 90};
+    const uint8_t black[3] = {0, 0, 0};
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(sclera, &grb[3 * (0 * 8 + 2)], 3);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(iris, &grb[3 * (1 * 8 + 2)], 3);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(sclera, &grb[3 * (2 * 8 + 2)], 3);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(lid, &grb[3 * (6 * 8 + 2)], 3);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(black, &grb[3 * (0 * 8 + 3)], 3);
+    // Same shape for the left eye, none of it lit
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(iris, &grb[3 * (WS2812_EYE_PIXELS + 2)], 3);
+}
+
+void test_render_serpentine()
+{
+    // One pixel per row at x = 1, left eye
+    uint8_t lit[8] = {0};
+    lit[1] = 0xFF;
+    EyesFrame frame = {lit, blankRows, NULL, 0xFF};
+    Ws2812Palette palette = {{1, 2, 3}, {0, 0, 0}, {0, 0, 0}};
+
+    ws2812Render(frame, palette, identity, false, grb);
+    for (uint8_t y = 0; y < 8; y++)
+    {
+        TEST_ASSERT_EQUAL_UINT8(2, grb[3 * (WS2812_EYE_PIXELS + y * 8 + 1)]);
+    }
+
+    ws2812Render(frame, palette, identity, true, grb);
+    for (uint8_t y = 0; y < 8; y++)
+    {
+        // Odd rows are wired right to left
+        uint8_t column = (y & 1) ? 6 : 1;
+        TEST_ASSERT_EQUAL_UINT8(2, grb[3 * (WS2812_EYE_PIXELS + y * 8 + column)]);
+        TEST_ASSERT_EQUAL_UINT8(0, grb[3 * (WS2812_EYE_PIXELS + y * 8 + 7 - column)]);
+    }
+}
+
+// Render and encode a frame with one lit pixel, then check every symbol
+static void assertFrameSymbols(bool serpentine, uint8_t intensity, uint8_t level)
+{
+    uint8_t lut[256];
+    ws2812BuildLut(gamma, intensity, lut);
+
+    // Left eye, x = 1, y = 1
+    uint8_t lit[8] = {0};
+    lit[1] = 0x40;
+    EyesFrame frame = {lit, blankRows, NULL, 0xFF};
+    Ws2812Palette palette = {{255, 0, 255}, {0, 0, 0}, {0, 0, 0}};
+
+    ws2812Render(frame, palette, lut, serpentine, grb);
+    size_t count = ws2812Encode(grb, WS2812_FRAME_BYTES, timing, symbols);
+    TEST_ASSERT_EQUAL(WS2812_FRAME_SYMBOLS, count);
+
+    uint16_t pixel = WS2812_EYE_PIXELS + 8 + (serpentine ? 6 : 1);
+    for (uint16_t i = 0; i < WS2812_PIXELS; i++)
+    {
+        const uint32_t *bits = &symbols[24 * i];
+        bool on = i == pixel;
+        assertByteSymbols(bits, 0);                   // G
+        assertByteSymbols(bits + 8, on ? level : 0);  // R
+        assertByteSymbols(bits + 16, on ? level : 0); // B
+    }
+    assertResetSymbol(symbols[count - 1]);
+}
+
+void test_frame_symbols_intensity_15()
+{
+    assertFrameSymbols(false, 15, 248);
+}
+
+void test_frame_symbols_intensity_0()
+{
+    assertFrameSymbols(false, 0, 8);
+}
+
+void test_frame_symbols_serpentine_intensity_15()
+{
+    assertFrameSymbols(true, 15, 248);
+}
+
+void test_frame_symbols_serpentine_intensity_0()
+{
+    assertFrameSymbols(true, 0, 8);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_symbol_layout);
+    RUN_TEST(test_encode_msb_first_then_reset);
+    RUN_TEST(test_lut_follows_intensity);
+    RUN_TEST(test_render_layers_grb);
+    RUN_TEST(test_render_serpentine);
+    RUN_TEST(test_frame_symbols_intensity_15);
+    RUN_TEST(test_frame_symbols_intensity_0);
+    RUN_TEST(test_frame_symbols_serpentine_intensity_15);
+    RUN_TEST(test_frame_symbols_serpentine_intensity_0);
+    return UNITY_END();
+}
@@ -0,0 +1,223 @@
+"""Build the asset pack image of the assets partition from assets/assets.json.
+
+Layout (little endian, see lib/AssetPack/AssetPackFormat.h):
+
+    header    magic "SKAP", version (u16), section count (u16),
+              size (u32), CRC-32 of the bytes after the header (u32)
+    sections  per section: type (u16), count (u16), offset (u32), size (u32)
+    data      sections aligned on 4 bytes
+
+Standalone:
+    python tools/asset_pack.py -o assets.bin assets/assets.json
+    python tools/asset_pack.py --dump assets.bin
+
+As a PlatformIO extra script, it builds the pack before each build and adds
+an "uploadassets" target writing it to the assets partition, without
+touching the firmware.
+"""
+
+import argparse
+import json
+import os
+import struct
+import sys
+import zlib
+
+MAGIC = 0x50414B53
+VERSION = 1
+ALIGN = 4
+HEADER = struct.Struct("<IHHII")
+SECTION = struct.Struct("<HHII")
+PARTITION_NAME = "assets"
+
+EYE_SHAPE = 1
+GAZE_POSITIONS = 2
+FONT = 3
+SOUNDS = 4
+SCENES = 5
+SCENE_EVENTS = 6
+MESSAGES = 7
+
+# Same order as GazePosition (lib/Behavior/Behavior.h)
+GAZE_NAMES = [
+    "top", "bottom", "left", "right", "center",
+    "top_left", "top_right", "bottom_left", "bottom_right",
+    "center_left", "center_right", "top_center", "bottom_center"]
+
+# Same order as SceneEventType (lib/Choreography/Choreography.h)
+SCENE_TYPES = [
+    "PLAY_SOUND", "GAZE", "MODE", "BLINK", "BRIGHTNESS", "WAIT_TRACK_END",
+    "FADE", "BREATHE", "FLASH", "TEXT", "START"]
+
+# Names accepted for the a and b values of scene events
+SCENE_VALUES = {"NORMAL": 0, "CLOSED": 1, "CROSS": 2, "SILLY": 3, "AUTO": 0xFF}
+
+SCENE_NAME_SIZE = 12
+
+
+def byte(value, what):
+    if isinstance(value, str):
+        if value not in SCENE_VALUES:
+            raise ValueError("%s: unknown value %r" % (what, value))
+        value = SCENE_VALUES[value]
+    if not 0 <= value <= 255:
+        raise ValueError("%s: %d out of range" % (what, value))
+    return value
+
+
+def eye_shape(assets):
+    shape = bytes(int(x, 16) for x in assets["eye_shape"])
+    if len(shape) != 8:
+        raise ValueError("eye_shape: 8 columns expected")
+    return len(shape), shape
+
+
+def gaze_positions(assets):
+    positions = assets["gaze_positions"]
+    names = [p["name"] for p in positions]
+    if names != GAZE_NAMES:
+        raise ValueError("gaze_positions: expected %s" % ", ".join(GAZE_NAMES))
+    data = bytearray()
+    for p in positions:
+        if not (0 <= p["x"] <= 6 and 0 <= p["y"] <= 6):
+            raise ValueError("gaze_positions: %s out of 0-6" % p["name"])
+        data += struct.pack("<BB", p["x"], p["y"])
+    return len(positions), bytes(data)
+
+
+def font(assets):
+    font = assets["font"]
+    width = font["width"]
+    glyphs = font["glyphs"]
+    first, last = min(map(ord, glyphs)), max(map(ord, glyphs))
+    data = bytearray(struct.pack("<BBBB", first, last, width, 0))
+    for code in range(first, last + 1):
+        columns = bytes.fromhex(glyphs.get(chr(code), "00" * width))
+        if len(columns) != width:
+            raise ValueError("font: %r is not %d columns wide" % (chr(code), width))
+        data += columns
+    return last - first + 1, bytes(data)
+
+
+def sounds(assets):
+    s = assets["sounds"]
+    data = struct.pack("<8B", s["yawning_folder"], s["speech_folder"], s["effect_folder"],
+                       s["yawning_count"], s["speech_count"], s["effect_count"], 0, 0)
+    return 1, data
+
+
+def scenes(assets):
+    table = bytearray()
+    events = bytearray()
+    count = 0
+    for scene in assets["scenes"]:
+        name = scene["name"].encode()
+        if len(name) >= SCENE_NAME_SIZE:
+            raise ValueError("scene %s: name longer than %d" % (scene["name"], SCENE_NAME_SIZE - 1))
+        if len(scene["events"]) > 255:
+            raise ValueError("scene %s: too many events" % scene["name"])
+        table += struct.pack("<%dsHBB" % SCENE_NAME_SIZE, name, count, len(scene["events"]), 0)
+        for at, kind, a, b in scene["events"]:
+            what = "scene %s at %d" % (scene["name"], at)
+            events += struct.pack("<HBBBB", at, SCENE_TYPES.index(kind),
+                                  byte(a, what), byte(b, what), 0)
+            count += 1
+    return (len(assets["scenes"]), bytes(table)), (count, bytes(events))
+
+
+def messages(assets):
+    texts = assets["messages"]
+    return len(texts), b"".join(t.encode("ascii") + b"\0" for t in texts)
+
+
+def build(assets):
+    sections = [
+        (EYE_SHAPE, eye_shape(assets)),
+        (GAZE_POSITIONS, gaze_positions(assets)),
+        (FONT, font(assets)),
+        (SOUNDS, sounds(assets)),
+        (MESSAGES, messages(assets)),
+    ]
+    scene_table, scene_events = scenes(assets)
+    sections += [(SCENES, scene_table), (SCENE_EVENTS, scene_events)]
+
+    offset = HEADER.size + SECTION.size * len(sections)
+    table = bytearray()
+    data = bytearray()
+    for kind, (count, payload) in sections:
+        data += b"\0" * (-(offset + len(data)) % ALIGN)
+        table += SECTION.pack(kind, count, offset + len(data), len(payload))
+        data += payload
+    body = bytes(table) + bytes(data)
+    size = HEADER.size + len(body)
+    return HEADER.pack(MAGIC, VERSION, len(sections), size, zlib.crc32(body)) + body
+
+
+def dump(image):
+    magic, version, count, size, crc = HEADER.unpack_from(image, 0)
+    ok = magic == MAGIC and zlib.crc32(image[HEADER.size:size]) == crc
+    print("version %d, %d sections, %d bytes, %s" % (version, count, size, "valid" if ok else "INVALID"))
+    for i in range(count):
+        kind, entries, offset, length = SECTION.unpack_from(image, HEADER.size + i * SECTION.size)
+        print("  type %d: %d entries, %d bytes at 0x%x" % (kind, entries, length, offset))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("source", nargs="?", help="assets JSON")
+    parser.add_argument("-o", "--output")
+    parser.add_argument("--dump", metavar="IMAGE", help="print the sections of a pack")
+    args = parser.parse_args()
+
+    if args.dump:
+        with open(args.dump, "rb") as f:
+            dump(f.read())
+        return
+    if not args.source or not args.output:
+        parser.error("source and --output are required")
+
+    with open(args.source) as f:
+        image = build(json.load(f))
+    with open(args.output, "wb") as f:
+        f.write(image)
+    print("%s: %d bytes" % (args.output, len(image)))
+
+
+def partition_offset(csv_path, name=PARTITION_NAME):
+    with open(csv_path) as f:
+        for line in f:
+            fields = [x.strip() for x in line.split("#")[0].split(",")]
+            if len(fields) >= 5 and fields[0] == name:
+                return int(fields[3], 0), int(fields[4], 0)
+    raise KeyError("no %s partition in %s" % (name, csv_path))
+
+
+def platformio(env):
+    project = env.subst("$PROJECT_DIR")
+    source = os.path.join(project, "assets", "assets.json")
+    image = os.path.join(env.subst("$BUILD_DIR"), "assets.bin")
+
+    os.makedirs(os.path.dirname(image), exist_ok=True)
+    with open(source) as f:
+        data = build(json.load(f))
+    csv = os.path.join(project, env.GetProjectOption("board_build.partitions"))
+    offset, size = partition_offset(csv)
+    if len(data) > size:
+        sys.exit("asset_pack: %d bytes do not fit in the assets partition" % len(data))
+    with open(image, "wb") as f:
+        f.write(data)
+
+    env.AddCustomTarget(
+        name="uploadassets",
+        dependencies=None,
+        actions=['"$PYTHONEXE" "$UPLOADER" --chip esp32 --port "$UPLOAD_PORT" '
+                 '--baud $UPLOAD_SPEED write_flash 0x%x "%s"' % (offset, image)],
+        title="Upload assets",
+        description="Write the asset pack to the assets partition")
+
+
+if __name__ == "__main__":
+    main()
+elif "Import" in globals():
+    Import("env")  # noqa: F821, defined when run by PlatformIO
+    platformio(env)  # noqa: F821
@@ -0,0 +1,234 @@
+"""Pack sound clips into the audio partition image played by FastAudio.
+
+Clips are decoded with ffmpeg, resampled to mono 16-bit PCM and encoded to
+IMA-ADPCM blocks. Layout (little endian, see lib/Sounds/AudioPack.h):
+
+    header  magic "SKAD", version (u16), clip count (u16), sample rate (u32)
+    table   per clip: folder (u8), track (u8), block size (u16),
+            offset (u32), samples (u32)
+    clips   IMA-ADPCM blocks, each clip aligned on 4 bytes
+
+Standalone:
+    python tools/audio_pack.py -o audio.bin ../sounds/02/001.mp3 ...
+    python tools/audio_pack.py --decode audio.bin 2 1 -o 001.raw
+
+As a PlatformIO extra script, it packs the clips listed in the
+custom_fast_sounds option before each build and adds an "uploadaudio"
+target writing the image to the audio partition.
+"""
+
+import argparse
+import os
+import struct
+import subprocess
+import sys
+
+MAGIC = 0x44414B53
+VERSION = 1
+HEADER = struct.Struct("<IHHI")
+CLIP = struct.Struct("<BBHII")
+BLOCK_HEADER = 4
+
+DEFAULT_RATE = 16000
+DEFAULT_BLOCK_SIZE = 256
+PARTITION_NAME = "audio"
+
+INDEX_TABLE = [-1, -1, -1, -1, 2, 4, 6, 8, -1, -1, -1, -1, 2, 4, 6, 8]
+STEP_TABLE = [
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17,
+    19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+    50, 55, 60, 66, 73, 80, 88, 97, 107, 118,
+    130, 143, 157, 173, 190, 209, 230, 253, 279, 307,
+    337, 371, 408, 449, 494, 544, 598, 658, 724, 796,
+    876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066,
+    2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428, 4871, 5358,
+    5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899,
+    15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767]
+
+
+def decode_nibble(code, predictor, index):
+    """Reference IMA step, shared by the encoder and the decoder."""
+    step = STEP_TABLE[index]
+    diff = step >> 3
+    if code & 4:
+        diff += step
+    if code & 2:
+        diff += step >> 1
+    if code & 1:
+        diff += step >> 2
+    predictor += -diff if code & 8 else diff
+    predictor = max(-32768, min(32767, predictor))
+    index = max(0, min(88, index + INDEX_TABLE[code]))
+    return predictor, index
+
+
+def encode_nibble(sample, predictor, index):
+    step = STEP_TABLE[index]
+    diff = sample - predictor
+    code = 0
+    if diff < 0:
+        code = 8
+        diff = -diff
+    if diff >= step:
+        code |= 4
+        diff -= step
+    step >>= 1
+    if diff >= step:
+        code |= 2
+        diff -= step
+    step >>= 1
+    if diff >= step:
+        code |= 1
+    return code
+
+
+def samples_per_block(block_size):
+    return (block_size - BLOCK_HEADER) * 2 + 1
+
+
+def encode(pcm, block_size=DEFAULT_BLOCK_SIZE):
+    """Encode 16-bit mono samples to IMA-ADPCM blocks, last block padded."""
+    per_block = samples_per_block(block_size)
+    out = bytearray()
+    index = 0
+    for start in range(0, len(pcm), per_block):
+        block = list(pcm[start:start + per_block])
+        block += [block[-1]] * (per_block - len(block))
+        predictor = block[0]
+        out += struct.pack("<hBB", predictor, index, 0)
+        codes = []
+        for sample in block[1:]:
+            code = encode_nibble(sample, predictor, index)
+            predictor, index = decode_nibble(code, predictor, index)
+            codes.append(code)
+        for i in range(0, len(codes), 2):
+            out.append(codes[i] | (codes[i + 1] << 4))
+    return bytes(out)
+
+
+def decode(data, samples, block_size):
+    """Reference decoder, the firmware must give the same samples."""
+    per_block = samples_per_block(block_size)
+    pcm = []
+    offset = 0
+    while len(pcm) < samples:
+        predictor, index, _ = struct.unpack_from("<hBB", data, offset)
+        index = min(index, 88)
+        pcm.append(predictor)
+        for byte in data[offset + BLOCK_HEADER:offset + block_size]:
+            for code in (byte & 0x0F, byte >> 4):
+                predictor, index = decode_nibble(code, predictor, index)
+                pcm.append(predictor)
+        offset += block_size
+    return pcm[:samples]
+
+
+def load_pcm(path, rate):
+    """Decode any file ffmpeg reads to mono 16-bit PCM at the given rate."""
+    raw = subprocess.run(
+        ["ffmpeg", "-v", "error", "-i", path, "-ac", "1", "-ar", str(rate),
+         "-f", "s16le", "-"],
+        check=True, stdout=subprocess.PIPE).stdout
+    return list(struct.unpack("<%dh" % (len(raw) // 2), raw))
+
+
+def clip_id(path):
+    """Folder and track of a DFPlayer path, e.g. 02/001.mp3 -> (2, 1)."""
+    folder = os.path.basename(os.path.dirname(os.path.abspath(path)))
+    track = os.path.splitext(os.path.basename(path))[0]
+    return int(folder), int(track)
+
+
+def pack(paths, rate=DEFAULT_RATE, block_size=DEFAULT_BLOCK_SIZE):
+    clips = [(clip_id(p), load_pcm(p, rate)) for p in paths]
+    offset = HEADER.size + CLIP.size * len(clips)
+    table = bytearray()
+    data = bytearray()
+    for (folder, track), pcm in clips:
+        padding = -(offset + len(data)) % 4
+        data += b"\0" * padding
+        table += CLIP.pack(folder, track, block_size, offset + len(data), len(pcm))
+        data += encode(pcm, block_size)
+    return HEADER.pack(MAGIC, VERSION, len(clips), rate) + bytes(table) + bytes(data)
+
+
+def unpack_clip(image, folder, track):
+    magic, version, count, rate = HEADER.unpack_from(image, 0)
+    if magic != MAGIC or version != VERSION:
+        raise ValueError("not an audio pack")
+    for i in range(count):
+        f, t, block_size, offset, samples = CLIP.unpack_from(image, HEADER.size + i * CLIP.size)
+        if (f, t) == (folder, track):
+            return decode(image[offset:], samples, block_size)
+    raise KeyError("clip %02d/%03d not packed" % (folder, track))
+
+
+def partition_offset(csv_path, name=PARTITION_NAME):
+    with open(csv_path) as f:
+        for line in f:
+            fields = [x.strip() for x in line.split("#")[0].split(",")]
+            if len(fields) >= 5 and fields[0] == name:
+                return int(fields[3], 0), int(fields[4], 0)
+    raise KeyError("no %s partition in %s" % (name, csv_path))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("inputs", nargs="*", help="clips to pack (folder/track.mp3)")
+    parser.add_argument("-o", "--output", required=True)
+    parser.add_argument("--rate", type=int, default=DEFAULT_RATE)
+    parser.add_argument("--block-size", type=int, default=DEFAULT_BLOCK_SIZE)
+    parser.add_argument("--decode", nargs=3, metavar=("IMAGE", "FOLDER", "TRACK"),
+                        help="write the reference decode of a packed clip (raw s16le)")
+    args = parser.parse_args()
+
+    if args.decode:
+        with open(args.decode[0], "rb") as f:
+            pcm = unpack_clip(f.read(), int(args.decode[1]), int(args.decode[2]))
+        with open(args.output, "wb") as f:
+            f.write(struct.pack("<%dh" % len(pcm), *pcm))
+        return
+
+    image = pack(args.inputs, args.rate, args.block_size)
+    with open(args.output, "wb") as f:
+        f.write(image)
+    print("%s: %d clips, %d bytes" % (args.output, len(args.inputs), len(image)))
+
+
+def platformio(env):
+    project = env.subst("$PROJECT_DIR")
+    sounds = env.GetProjectOption("custom_fast_sounds", "").split()
+    paths = [os.path.join(project, "..", "sounds", s) for s in sounds]
+    image = os.path.join(env.subst("$BUILD_DIR"), "audio.bin")
+
+    sources = [p for p in paths if os.path.exists(p)]
+    if len(sources) != len(paths):
+        print("audio_pack: missing clips, they will play on the DFPlayer")
+    if sources:
+        newest = max(os.path.getmtime(p) for p in sources + [os.path.join(project, "tools", "audio_pack.py")])
+        if not os.path.exists(image) or os.path.getmtime(image) < newest:
+            os.makedirs(os.path.dirname(image), exist_ok=True)
+            data = pack(sources)
+            with open(image, "wb") as f:
+                f.write(data)
+            print("audio_pack: %d clips, %d bytes" % (len(sources), len(data)))
+
+    csv = os.path.join(project, env.GetProjectOption("board_build.partitions"))
+    offset, size = partition_offset(csv)
+    if os.path.exists(image) and os.path.getsize(image) > size:
+        sys.exit("audio_pack: %s does not fit in the audio partition" % image)
+
+    env.AddCustomTarget(
+        name="uploadaudio",
+        dependencies=None,
+        actions=['"$PYTHONEXE" "$UPLOADER" --chip esp32 --port "$UPLOAD_PORT" '
+                 '--baud $UPLOAD_SPEED write_flash 0x%x "%s"' % (offset, image)],
+        title="Upload audio",
+        description="Write the packed clips to the audio partition")
+
+
+if __name__ == "__main__":
+    main()
+elif "Import" in globals():
+    Import("env")  # noqa: F821, defined when run by PlatformIO
+    platformio(env)  # noqa: F821